@@ -9,6 +9,7 @@
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <string_view>
 #include <vector>
 
 namespace pul::animation {
@@ -36,7 +37,9 @@ namespace pul::animation {
     Pieces are connected together using "parent" and thus they get
     skeletal-esque animation as their offsets are compounded together.
 
-  TODO change std::string to size_t and use std::hash
+  Labels are only used to load, edit & set up animations; once loaded the
+    animator is compiled so the runtime addresses pieces & states by index,
+    in the (sorted) order of their maps.
 
   */
 
@@ -49,6 +52,10 @@ namespace pul::animation {
     uint32_t msDeltaTimeOverride = -1u;
     size_t numHitboxes = 0; // max 8
     std::array<pul::util::ComponentHitboxAABB, 8> hitboxes;
+
+    // compiled uv coords of the piece's quad, indexed by x-axis flip then by
+    // vertex; see Animator::CompileUvCoords
+    std::array<std::array<glm::vec2, 6>, 2> uvCoords = {};
   };
 
   enum class VariationType {
@@ -126,12 +133,30 @@ namespace pul::animation {
       glm::u32vec2 dimensions = {};
       glm::i32vec2 origin = {};
       int16_t renderDepth = 0; // valid from -127 .. 128
+
+      // compiled, see Animator::Compile; labels point into the keys of
+      // `states`
+      std::vector<pul::animation::Animator::State *> stateByIdx = {};
+      std::vector<std::string_view> stateLabels = {};
+
+      // -1ul if there is no state of that label
+      size_t StateIdx(std::string_view label) const;
     };
 
     struct SkeletalPiece {
       std::string label;
       glm::i32vec2 origin = {};
       std::vector<SkeletalPiece> children = {};
+
+      // compiled, see Animator::Compile; -1ul if there is no such piece
+      size_t pieceIdx = -1ul;
+    };
+
+    // skeletal piece of the flattened skeleton, see Animator::Compile
+    struct FlatSkeletalPiece {
+      size_t pieceIdx = -1ul;
+      size_t parentIdx = -1ul; // -1ul for root pieces
+      glm::i32vec2 origin = {};
     };
 
     // -- members
@@ -141,6 +166,33 @@ namespace pul::animation {
     glm::uvec2 uvCoordOffset = glm::uvec2(0);
     std::string label;
     std::string filename;
+
+    // compiled, see Compile; labels point into the keys of `pieces`
+    std::vector<Piece *> pieceByIdx = {};
+    std::vector<std::string_view> pieceLabels = {};
+
+    // compiled skeleton in depth-first order, which is also the order pieces
+    // are laid out in the vertex buffers; parents always precede children so
+    // it can be evaluated in a single pass
+    std::vector<FlatSkeletalPiece> flatSkeleton = {};
+
+    // incremented by Compile, so that state recorded against an earlier
+    // compile, whose piece & state indices may no longer hold, can be told
+    // apart
+    size_t compileGeneration = 0ul;
+
+    // interns piece & state labels into indices & flattens the skeleton; must
+    // be called after loading and whenever pieces, states or the skeleton are
+    // edited. Skeletal pieces referring to a missing piece are left out of
+    // the flattened skeleton, their children attach to their parent
+    void Compile();
+
+    // precomputes the uv coords of every component; called by Compile, but
+    // must also be called when tiles, dimensions or the uv offset are edited
+    void CompileUvCoords();
+
+    // -1ul if there is no piece of that label
+    size_t PieceIdx(std::string_view label) const;
   };
 
   struct System {
@@ -170,16 +222,65 @@ namespace pul::animation {
       bool flipVertWrap = false;
 
       std::shared_ptr<Animator> animator;
-      std::string pieceLabel;
+      size_t pieceIdx = -1ul;
+      size_t stateIdx = -1ul; // of `label`, -1ul if the piece has no such state
 
       VariationRuntimeInfo variationRti = {};
 
+      // the timeline looped a random variation, which must be re-rolled;
+      // instances are stepped in parallel, so this is done serially after
+      bool variationRespin = false;
+
       glm::mat3 cachedLocalSkeletalMatrix = glm::mat3(0.0f);
 
+      // what the cached matrices were computed from; they're only recomputed
+      // if these, or the parent piece's matrices, change
+      struct CachedInputs {
+        std::vector<Component> const * components = nullptr;
+        size_t componentIt = -1ul;
+        float angle = 0.0f;
+        float deltaTime = 0.0f; // only tracked if the origin interpolates
+        bool flip = false;
+
+        bool operator==(CachedInputs const &) const = default;
+      };
+
+      CachedInputs cachedInputs = {};
+
+      // skeletal matrix passed down to the children of this piece
+      glm::mat3 cachedSkeletalMatrix = glm::mat3(1.0f);
+
       void Apply(std::string const & nLabel, bool force = false);
     };
 
-    std::map<std::string, StateInfo> pieceToState = {};
+    // indexed by the animator's piece idx
+    std::vector<StateInfo> pieceStates = {};
+
+    // label lookups for gameplay setup, tools & the editor; logs an error and
+    // returns a dummy state if the animator has no such piece
+    StateInfo & PieceState(std::string_view pieceLabel);
+
+    // nullptr if the animator has no such piece
+    StateInfo * FindPieceState(std::string_view pieceLabel);
+
+    // by piece idx, for the per-tick gameplay paths; like PieceState(label)
+    // a missing piece (-1ul) logs an error and returns a dummy state
+    StateInfo & PieceState(size_t pieceIdx);
+    StateInfo const & PieceState(size_t pieceIdx) const;
+
+    // indices of the pieces gameplay reads every tick, resolved from their
+    // labels by plugin::animation::ConstructInstance, which also runs when
+    // the editor rebuilds instances; -1ul if the animator has no such piece
+    struct GameplayPieces {
+      size_t body = -1ul;
+      size_t legs = -1ul;
+      size_t particle = -1ul;
+      size_t pickupBg = -1ul;
+      size_t pickups = -1ul;
+      size_t weaponPlaceholder = -1ul;
+    };
+
+    GameplayPieces gameplayPieces = {};
 
     // if set to false, the matrix will no longer be recalculated every render
     // frame. This allows an animation matrix to not have to be set every frame
@@ -187,6 +288,23 @@ namespace pul::animation {
 
     bool hasCalculatedCachedInfo = false;
 
+    // root the cached matrices were computed from
+    struct CachedRoot {
+      glm::mat3 skeletalMatrix = glm::mat3(1.0f);
+      float skeletalRotation = 0.0f;
+      bool skeletalFlip = false;
+      bool valid = false; // every piece is recomputed while false
+
+      bool operator==(CachedRoot const &) const = default;
+    };
+
+    CachedRoot cachedRoot = {};
+
+    // culled or invisible instances only have their timeline advanced each
+    // frame; set this if gameplay logic reads the cached matrices regardless
+    // (ei the player's weapon-placeholder for hitscan)
+    bool alwaysComputeCachedMatrix = false;
+
     // TODO this should come from componentOrigin
     glm::vec2 origin = glm::vec2(0.0);
 
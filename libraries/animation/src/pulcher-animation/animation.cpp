@@ -1,8 +1,16 @@
 #include <pulcher-animation/animation.hpp>
 
+#include <pulcher-util/consts.hpp>
 #include <pulcher-util/log.hpp>
+#include <pulcher-util/parallel.hpp>
 #include <pulcher-util/random.hpp>
 
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include <set>
+#include <string>
+
 size_t pul::animation::Animator::State::VariationIdxLookup(
   VariationRuntimeInfo const & variationRti
 ) {
@@ -65,7 +73,21 @@ void pul::animation::Instance::StateInfo::Apply(
 
   variationRti = {};
 
-  auto const & state = animator->pieces[pieceLabel].states[label];
+  // dummy state of PieceState
+  if (!animator || pieceIdx == -1ul) { return; }
+
+  auto const & piece = *animator->pieceByIdx[pieceIdx];
+  stateIdx = piece.StateIdx(label);
+
+  if (stateIdx == -1ul) {
+    spdlog::error(
+      "no state '{}' for piece '{}' of '{}'"
+    , label, animator->pieceLabels[pieceIdx], animator->label
+    );
+    return;
+  }
+
+  auto const & state = *piece.stateByIdx[stateIdx];
 
   switch (state.variationType) {
     default: spdlog::error("variation type default"); break;
@@ -78,6 +100,204 @@ void pul::animation::Instance::StateInfo::Apply(
   }
 }
 
+pul::animation::Instance::StateInfo *
+pul::animation::Instance::FindPieceState(std::string_view pieceLabel) {
+  if (!animator) { return nullptr; }
+
+  size_t const pieceIdx = animator->PieceIdx(pieceLabel);
+  if (pieceIdx == -1ul || pieceIdx >= pieceStates.size()) { return nullptr; }
+
+  return &pieceStates[pieceIdx];
+}
+
+namespace {
+
+// handed out by PieceState for missing pieces, one per ParallelFor thread. Not
+// thread_local, as those would keep a plugin linking this from unloading
+std::array<
+  pul::animation::Instance::StateInfo, pul::util::maxParallelThreads
+> missingPieceStates;
+
+// labels of missing pieces that have already been reported, so a lookup done
+// every frame doesn't flood the log; PieceState can be called from any
+// ParallelFor thread
+std::mutex missingPieceLabelsMutex;
+std::set<std::string, std::less<>> missingPieceLabels;
+
+} // -- namespace
+
+pul::animation::Instance::StateInfo &
+pul::animation::Instance::PieceState(std::string_view pieceLabel) {
+  if (auto * stateInfo = this->FindPieceState(pieceLabel); stateInfo)
+    { return *stateInfo; }
+
+  {
+    std::lock_guard<std::mutex> lock(::missingPieceLabelsMutex);
+    if (::missingPieceLabels.find(pieceLabel) == ::missingPieceLabels.end()) {
+      ::missingPieceLabels.emplace(pieceLabel);
+      spdlog::error(
+        "no piece '{}' in animation '{}'"
+      , pieceLabel, animator ? animator->label : "n/a"
+      );
+    }
+  }
+
+  auto & missing = ::missingPieceStates[pul::util::ParallelWorkerIdx()];
+  missing = {};
+  return missing;
+}
+
+pul::animation::Instance::StateInfo &
+pul::animation::Instance::PieceState(size_t const pieceIdx) {
+  if (pieceIdx < pieceStates.size()) { return pieceStates[pieceIdx]; }
+
+  // an unresolved index is reported once per animator, under its label
+  {
+    auto const label = fmt::format("#{}", animator ? animator->label : "n/a");
+    std::lock_guard<std::mutex> lock(::missingPieceLabelsMutex);
+    if (::missingPieceLabels.find(label) == ::missingPieceLabels.end()) {
+      ::missingPieceLabels.emplace(label);
+      spdlog::error(
+        "missing gameplay piece in animation '{}'"
+      , animator ? animator->label : "n/a"
+      );
+    }
+  }
+
+  auto & missing = ::missingPieceStates[pul::util::ParallelWorkerIdx()];
+  missing = {};
+  return missing;
+}
+
+pul::animation::Instance::StateInfo const &
+pul::animation::Instance::PieceState(size_t const pieceIdx) const {
+  return const_cast<pul::animation::Instance &>(*this).PieceState(pieceIdx);
+}
+
+size_t pul::animation::Animator::Piece::StateIdx(
+  std::string_view const label
+) const {
+  // labels are sorted as they come from the map
+  auto const state =
+    std::lower_bound(stateLabels.begin(), stateLabels.end(), label);
+  if (state == stateLabels.end() || *state != label) { return -1ul; }
+  return std::distance(stateLabels.begin(), state);
+}
+
+namespace {
+
+void CompileUvCoords(
+  std::vector<pul::animation::Component> & components
+, glm::vec2 const pieceDimensions
+, glm::uvec2 const uvCoordOffset
+, glm::vec2 const invResolution
+) {
+  for (auto & component : components)
+  for (size_t flip = 0ul; flip < 2ul; ++ flip)
+  for (size_t it = 0ul; it < 6ul; ++ it) {
+    auto uv = pul::util::TriangleVertexArray()[it];
+    if (flip) { uv.x = 1.0f - uv.x; }
+
+    component.uvCoords[flip][it] =
+      (
+          (uv*pieceDimensions + glm::vec2(component.tile)*pieceDimensions)
+        + glm::vec2(uvCoordOffset)
+      )
+      * invResolution
+    ;
+  }
+}
+
+void CompileSkeleton(
+  pul::animation::Animator & animator
+, std::vector<pul::animation::Animator::SkeletalPiece> & skeletals
+, size_t const parentIdx
+) {
+  for (auto & skeletal : skeletals) {
+    skeletal.pieceIdx = animator.PieceIdx(skeletal.label);
+
+    // a missing piece has no states, so it would only pass its parent's
+    // matrix through; its children are attached to the parent instead, which
+    // keeps it out of `pieces` and so out of the saved animation
+    if (skeletal.pieceIdx == -1ul) {
+      spdlog::error(
+        "skeleton of '{}' refers to missing piece '{}'"
+      , animator.label, skeletal.label
+      );
+      ::CompileSkeleton(animator, skeletal.children, parentIdx);
+      continue;
+    }
+
+    animator.flatSkeleton.emplace_back(
+      pul::animation::Animator::FlatSkeletalPiece {
+        .pieceIdx = skeletal.pieceIdx
+      , .parentIdx = parentIdx
+      , .origin = skeletal.origin
+      }
+    );
+
+    ::CompileSkeleton(
+      animator, skeletal.children, animator.flatSkeleton.size()-1ul
+    );
+  }
+}
+
+} // -- namespace
+
+void pul::animation::Animator::Compile() {
+  pieceByIdx.clear();
+  pieceLabels.clear();
+  for (auto & [pieceLabel, piece] : pieces) {
+    pieceByIdx.emplace_back(&piece);
+    pieceLabels.emplace_back(pieceLabel);
+
+    piece.stateByIdx.clear();
+    piece.stateLabels.clear();
+    for (auto & [stateLabel, state] : piece.states) {
+      piece.stateByIdx.emplace_back(&state);
+      piece.stateLabels.emplace_back(stateLabel);
+    }
+  }
+
+  flatSkeleton.clear();
+  ::CompileSkeleton(*this, skeleton, -1ul);
+
+  ++ compileGeneration;
+
+  this->CompileUvCoords();
+}
+
+void pul::animation::Animator::CompileUvCoords() {
+  auto const invResolution = spritesheet.InvResolution();
+
+  for (auto & [pieceLabel, piece] : pieces) {
+    auto const pieceDimensions = glm::vec2(piece.dimensions);
+    for (auto & [stateLabel, state] : piece.states)
+    for (auto & variation : state.variations) {
+      ::CompileUvCoords(
+        variation.range.data[0], pieceDimensions, uvCoordOffset, invResolution
+      );
+      ::CompileUvCoords(
+        variation.range.data[1], pieceDimensions, uvCoordOffset, invResolution
+      );
+      ::CompileUvCoords(
+        variation.random.data, pieceDimensions, uvCoordOffset, invResolution
+      );
+      ::CompileUvCoords(
+        variation.normal.data, pieceDimensions, uvCoordOffset, invResolution
+      );
+    }
+  }
+}
+
+size_t pul::animation::Animator::PieceIdx(std::string_view label) const {
+  // labels are sorted as they come from the map
+  auto const piece =
+    std::lower_bound(pieceLabels.begin(), pieceLabels.end(), label);
+  if (piece == pieceLabels.end() || *piece != label) { return -1ul; }
+  return std::distance(pieceLabels.begin(), piece);
+}
+
 char const * ToStr(pul::animation::VariationType type) {
   switch (type) {
     default: return "n/a";
@@ -79,6 +79,9 @@ namespace pul::core {
     pul::animation::Instance animationInstance;
     bool * audioTrigger = nullptr; // really silly
 
+    // swept against tiles & hitboxes each frame, zero sweeps a point
+    float collisionRadius = 0.0f;
+
     ProjectileDamageInfo damage = {};
   };
 }
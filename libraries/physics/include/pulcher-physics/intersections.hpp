@@ -1,15 +1,16 @@
 #pragma once
 
 #include <pulcher-core/map.hpp>
+#include <pulcher-physics/tileset.hpp>
 
 #include <entt/entt.hpp>
 #include <glm/glm.hpp>
 
 #include <array>
+#include <span>
+#include <unordered_map>
 #include <vector>
 
-namespace pul::physics { struct Tileset; }
-
 namespace pul::physics {
 
   enum class IntersectorType : size_t {
@@ -17,6 +18,8 @@ namespace pul::physics {
   , Ray    = 0x20000000
   , Circle = 0x40000000
   , Aabb   = 0x80000000
+  , SweptAabb = 0x08000000
+  , SweptCircle = 0x04000000
   };
 
   struct IntersectorPoint {
@@ -42,6 +45,32 @@ namespace pul::physics {
     glm::vec2 dimensions;
   };
 
+  // aabb moving along velocity over a single frame
+  struct IntersectorSweptAabb {
+    static IntersectorType constexpr type = IntersectorType::SweptAabb;
+
+    // inputs
+    glm::vec2 origin;
+    glm::vec2 dimensions;
+    glm::vec2 velocity;
+  };
+
+  // circle moving along velocity over a single frame, tested against both the
+  // collision layer and entity hitboxes; a radius of zero sweeps a point
+  struct IntersectorSweptCircle {
+    static IntersectorType constexpr type = IntersectorType::SweptCircle;
+
+    // inputs
+    glm::vec2 origin;
+    glm::vec2 velocity;
+    float radius = 0.0f;
+    entt::entity ignoredEntity = entt::null;
+    // further entities the circle passes through
+    std::span<entt::entity const> ignoredEntities = {};
+
+    bool testLayer = true, testEntities = true;
+  };
+
   struct IntersectorRay {
     static IntersectorType constexpr type = IntersectorType::Ray;
 
@@ -54,11 +83,58 @@ namespace pul::physics {
     );
   };
 
+  // ray against entity hitboxes, see EntityIntersectionRaycastSorted
+  struct IntersectorEntityRay {
+    static IntersectorType constexpr type = IntersectorType::Ray;
+
+    // inputs
+    IntersectorRay ray;
+    entt::entity ignoredEntity = entt::null;
+
+    // ends the ray at the first collision layer texel it hits
+    bool stopAtLayer = false;
+
+    // only reports entities that can take damage, so hits aren't taken up by
+    // hitboxes the caller would skip
+    bool damageableOnly = false;
+  };
+
   struct IntersectionResults {
     bool collision = false;
     glm::i32vec2 origin = glm::i32vec2(0);
 
     size_t imageTileIdx = -1ul, tilesetIdx = -1ul;
+
+    // world-space surface normal at origin, zero if it could not be derived
+    glm::vec2 normal = glm::vec2(0.0f);
+  };
+
+  struct SweptIntersectionResults {
+    bool collision = false;
+    // fraction of the velocity that can be travelled before contact
+    float timeOfImpact = 1.0f;
+    glm::vec2 normal = glm::vec2(0.0f);
+    glm::i32vec2 origin = glm::i32vec2(0); // texel that was hit
+
+    size_t imageTileIdx = -1ul, tilesetIdx = -1ul;
+  };
+
+  struct SweptCircleIntersectionResults {
+    bool collision = false;
+    // fraction of the velocity that can be travelled before contact
+    float timeOfImpact = 1.0f;
+    glm::vec2 normal = glm::vec2(0.0f);
+    glm::vec2 origin = glm::vec2(0.0f); // circle origin at time of impact
+
+    // null if the collision layer was hit first
+    entt::entity entity = entt::null;
+    size_t imageTileIdx = -1ul, tilesetIdx = -1ul;
+  };
+
+  struct EntityRaycastHit {
+    float timeOfImpact = 1.0f; // fraction of the ray before entering hitbox
+    glm::i32vec2 origin = glm::i32vec2(0);
+    entt::entity entity = entt::null;
   };
 
   struct EntityIntersectionResults {
@@ -97,17 +173,119 @@ namespace pul::physics {
   struct TilemapLayer {
     std::vector<pul::physics::Tileset const *> tilesets;
 
+    // packed into 32 bits so large layers stay cache friendly; bits 0..2 hold
+    // the orientation, 3..10 the tileset idx & 11..31 the image tile idx. The
+    // tile origin is implied by its index in the chunk
     struct TileInfo {
-      size_t imageTileIdx = -1ul;
-      size_t tilesetIdx = -1ul;
-      pul::core::TileOrientation orientation = pul::core::TileOrientation::None;
-      glm::vec2 origin;
+      static uint32_t constexpr orientationBits = 3u;
+      static uint32_t constexpr tilesetBits = 8u;
+      static uint32_t constexpr imageTileBits = 21u;
+
+      static size_t constexpr maxTilesets = (1ul << tilesetBits) - 1ul;
+      static size_t constexpr maxImageTiles = 1ul << imageTileBits;
 
-      bool Valid() const { return tilesetIdx != -1ul; }
+      // all tileset bits set marks an invalid tile
+      uint32_t packed = static_cast<uint32_t>(maxTilesets) << orientationBits;
+
+      static TileInfo Construct(
+        size_t tilesetIdx, size_t imageTileIdx
+      , pul::core::TileOrientation orientation
+      );
+
+      size_t ImageTileIdx() const {
+        return packed >> (orientationBits + tilesetBits);
+      }
+
+      size_t TilesetIdx() const {
+        return (packed >> orientationBits) & maxTilesets;
+      }
+
+      pul::core::TileOrientation Orientation() const {
+        return
+          static_cast<pul::core::TileOrientation>(
+            packed & ((1u << orientationBits) - 1u)
+          );
+      }
+
+      bool Valid() const { return this->TilesetIdx() != maxTilesets; }
     };
 
-    std::vector<TileInfo> tileInfo;
-    uint32_t width;
+    static_assert(sizeof(TileInfo) == 4ul);
+
+    // the layer is stored in chunks of chunkTiles*chunkTiles tiles, only
+    // loaded chunks take up memory and everything else is empty space
+    static int32_t constexpr chunkTiles = 32;
+    static int32_t constexpr chunkTexels = chunkTiles*32;
+
+    struct Chunk {
+      glm::i32vec2 origin = glm::i32vec2(0); // in chunks
+
+      // row by row
+      std::array<TileInfo, chunkTiles*chunkTiles> tileInfo;
+
+      // summed-area table of the solid texel counts of the chunk tiles, with
+      // an extra leading row & column of zeroes; entry (x, y) is the amount of
+      // solid texels in tiles [0, x) * [0, y), stored at y*(chunkTiles+1) + x
+      std::array<uint32_t, (chunkTiles+1)*(chunkTiles+1)> solidTileSums;
+
+      // occupancy pyramid over the chunk tiles; level l has cells of (32 << l)
+      // texels, (chunkTiles >> l) per row, up to a single cell for the chunk.
+      // It marks cells that contain any solid texel and cells that contain any
+      // empty texel. Below tile level the tile masks take over
+      struct OccupancyLevel {
+        std::vector<uint8_t> solid, empty;
+      };
+
+      std::vector<OccupancyLevel> occupancyPyramid;
+
+      // world-space surface normals of the texels within Tile::normalRadius
+      // of a tile border, which depend on the neighbouring tiles & chunks;
+      // the other texels use the normals of their physics tile. Only tiles
+      // whose border normals differ from those of their physics tile have
+      // an entry in seamNormals, seamNormalIdx is -1u for the rest
+      static size_t constexpr seamTexels =
+          Tile::gridSize*Tile::gridSize
+        - (Tile::gridSize - 2ul*Tile::normalRadius)
+        * (Tile::gridSize - 2ul*Tile::normalRadius)
+      ;
+
+      std::array<uint32_t, chunkTiles*chunkTiles> seamNormalIdx;
+      std::vector<std::array<std::array<int8_t, 2>, seamTexels>> seamNormals;
+    };
+
+    // keyed by GridKey of the chunk origin
+    std::unordered_map<uint64_t, Chunk> chunks;
+
+    static uint64_t GridKey(glm::i32vec2 const origin) {
+      return
+          static_cast<uint64_t>(static_cast<uint32_t>(origin.y)) << 32ul
+        | static_cast<uint64_t>(static_cast<uint32_t>(origin.x))
+      ;
+    }
+
+    Chunk const * FindChunk(glm::i32vec2 const chunkOrigin) const {
+      auto const chunk = chunks.find(GridKey(chunkOrigin));
+      return chunk == chunks.end() ? nullptr : &chunk->second;
+    }
+  };
+
+  inline TilemapLayer::TileInfo TilemapLayer::TileInfo::Construct(
+    size_t const tilesetIdx, size_t const imageTileIdx
+  , pul::core::TileOrientation const orientation
+  ) {
+    TileInfo self;
+    self.packed =
+        static_cast<uint32_t>(orientation)
+      | static_cast<uint32_t>(tilesetIdx) << orientationBits
+      | static_cast<uint32_t>(imageTileIdx) << (orientationBits + tilesetBits)
+    ;
+    return self;
+  }
+
+  // collision data of the loaded map. Only written while a map or chunk is
+  // loaded, so queries taking it as const can run from any amount of threads
+  struct PhysicsWorld {
+    TilemapLayer tilemapLayer;
   };
 
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
 #include <vector>
 
 // SDF tilesets
@@ -15,8 +16,34 @@ namespace pul::physics {
 
   struct Tile {
     static size_t constexpr gridSize = 32ul;
-    std::array<std::array<float, gridSize>, gridSize> signedDistanceField;
-    std::array<std::array<uint8_t, gridSize>, gridSize> accelerationHints;
+    static_assert(gridSize == 32ul, "collision masks are stored as uint32_t");
+
+    // one bit per texel, set for solid texels. Bit x of rowMasks[y] and bit y
+    // of columnMasks[x] refer to the same texel, so that a span of texels in
+    // either direction is a single word
+    std::array<uint32_t, gridSize> rowMasks;
+    std::array<uint32_t, gridSize> columnMasks;
+
+    // chessboard distance from each texel to the nearest texel of opposite
+    // solidity within the tile, capped at gridSize. Negative for solid texels,
+    // positive for empty texels
+    std::array<std::array<int8_t, gridSize>, gridSize> signedDistanceField;
+
+    // surface normal of each texel in tile-space, pointing away from the solid
+    // texels within normalRadius and quantized to [-127, 127]. Texels outside
+    // of the tile are clamped to its border; the collision layer corrects the
+    // texels near the border once the neighbouring tiles are known. Zero if
+    // the texel's neighbourhood is uniformly solid or empty
+    static size_t constexpr normalRadius = 2ul;
+    std::array<std::array<std::array<int8_t, 2>, gridSize>, gridSize>
+      surfaceNormals;
+
+    // classification of the entire tile
+    TileIntersectAccelerationHint accelerationHint;
+
+    bool Solid(size_t const x, size_t const y) const {
+      return (rowMasks[y] >> x) & 1u;
+    }
   };
 
   struct Tileset {
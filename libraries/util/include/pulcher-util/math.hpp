@@ -26,8 +26,6 @@ namespace pul::physics {
       steep = true;
     }
 
-
-    uint32_t maxSteps = 1'000u;
     if (f0.x > f1.x) {
       int32_t
         dx = f0.x-f1.x
@@ -38,7 +36,6 @@ namespace pul::physics {
       ;
 
       for (glm::ivec2 f = f0; f.x >= f1.x; -- f.x) {
-        if (--maxSteps == 0u) { break; }
         if (steep) { fn(f.y, f.x); } else { fn(f.x, f.y); }
         error += derror;
         if (error > dx) {
@@ -56,7 +53,6 @@ namespace pul::physics {
       ;
 
       for (glm::ivec2 f = f0; f.x <= f1.x; ++ f.x) {
-        if (--maxSteps == 0u) { break; }
         if (steep) { fn(f.y, f.x); } else { fn(f.x, f.y); }
         error += derror;
         if (error > dx) {
@@ -67,4 +63,83 @@ namespace pul::physics {
     }
 
   }
+
+  // parametric form of BresenhamLine; the texel at any step along the major
+  // axis is computed directly, so traversals can skip over texels
+  struct BresenhamLineParametric {
+    // major axis stored in x, minor axis in y, swapped back by Texel
+    glm::ivec2 origin;
+    int64_t dx, dy, stepx, stepy;
+    bool steep;
+
+    static BresenhamLineParametric Construct(glm::ivec2 f0, glm::ivec2 f1) {
+      BresenhamLineParametric self;
+      self.steep = glm::abs(f0.x-f1.x) < glm::abs(f0.y-f1.y);
+      if (self.steep) {
+        std::swap(f0.x, f0.y);
+        std::swap(f1.x, f1.y);
+      }
+
+      self.origin = f0;
+      self.dx = glm::abs(f1.x-f0.x);
+      self.dy = glm::abs(f1.y-f0.y);
+      self.stepx = f1.x >= f0.x ? +1 : -1;
+      self.stepy = f1.y > f0.y ? +1 : -1;
+      return self;
+    }
+
+    // last valid step
+    int64_t Length() const { return dx; }
+
+    // closed form of the error accumulation in BresenhamLine
+    int64_t Minor(int64_t const step) const {
+      return dx == 0 ? 0 : (2*step*dy + dx - 1) / (2*dx);
+    }
+
+    glm::ivec2 Texel(int64_t const step) const {
+      auto const texel =
+        glm::ivec2(
+          static_cast<int32_t>(origin.x + step*stepx)
+        , static_cast<int32_t>(origin.y + this->Minor(step)*stepy)
+        );
+      return steep ? glm::ivec2(texel.y, texel.x) : texel;
+    }
+
+    // first step at which the minor axis has advanced `minorOffset` texels
+    int64_t StepOfMinor(int64_t const minorOffset) const {
+      if (dy == 0) { return dx+1; }
+      int64_t const numerator = 2*dx*minorOffset - dx + 1;
+      return (numerator + 2*dy - 1) / (2*dy);
+    }
+
+    // first step after `step` where the minor axis changes
+    int64_t NextMinorStep(int64_t const step) const {
+      return this->StepOfMinor(this->Minor(step) + 1);
+    }
+
+    // first step after `step` where the texel leaves its grid cell, for a grid
+    // of cellSize texels that is aligned to the origin
+    int64_t NextCellStep(int64_t const step, int64_t const cellSize) const {
+      auto const floorDiv = [](int64_t const a, int64_t const b) {
+        return a >= 0 ? a / b : -((-a + b - 1) / b);
+      };
+
+      int64_t const major = origin.x + step*stepx;
+      int64_t const minor = origin.y + this->Minor(step)*stepy;
+
+      int64_t const majorExit =
+        stepx > 0
+      ? step + (floorDiv(major, cellSize)+1)*cellSize - major
+      : step + major - floorDiv(major, cellSize)*cellSize + 1
+      ;
+
+      int64_t const minorExit =
+        stepy > 0
+      ? this->StepOfMinor((floorDiv(minor, cellSize)+1)*cellSize - origin.y)
+      : this->StepOfMinor(origin.y - floorDiv(minor, cellSize)*cellSize + 1)
+      ;
+
+      return glm::min(majorExit, minorExit);
+    }
+  };
 }
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+
+namespace pul::util {
+  // calls `fn(begin, end)` over contiguous ranges of [0, count) from a pool of
+  // worker threads as well as the calling thread, and returns once every range
+  // has been processed. Ranges are at least `minRangeSize` long, so small
+  // workloads stay on the calling thread. Not reentrant; `fn` must not call
+  // ParallelFor itself. Ranges are handed out dynamically, so `fn` must not
+  // draw random numbers, their order would depend on thread scheduling
+  template <typename Fn>
+  void ParallelFor(size_t count, size_t minRangeSize, Fn const & fn);
+
+  // upper bound of ParallelThreadCount
+  size_t constexpr maxParallelThreads = 16ul;
+
+  // worker threads + the calling thread
+  size_t ParallelThreadCount();
+
+  // index of the calling thread in [0, ParallelThreadCount()); 0 for the
+  // thread that calls ParallelFor (and any thread outside of the pool), the
+  // workers follow from 1. Per-thread scratch is kept in plain arrays indexed
+  // by this rather than in thread_local objects, as a thread_local with a
+  // destructor keeps a plugin from being unloaded
+  size_t ParallelWorkerIdx();
+
+  void ParallelForRanges(
+    size_t count, size_t minRangeSize
+  , void (*fn)(void const * userdata, size_t begin, size_t end)
+  , void const * userdata
+  );
+}
+
+template <typename Fn>
+void pul::util::ParallelFor(
+  size_t const count, size_t const minRangeSize, Fn const & fn
+) {
+  pul::util::ParallelForRanges(
+    count, minRangeSize
+  , [](void const * userdata, size_t const begin, size_t const end) {
+      (*reinterpret_cast<Fn const *>(userdata))(begin, end);
+    }
+  , &fn
+  );
+}
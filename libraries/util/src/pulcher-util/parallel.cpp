@@ -0,0 +1,165 @@
+#include <pulcher-util/parallel.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// trivially destructible, so it doesn't register a thread exit destructor
+thread_local size_t parallelWorkerIdx = 0ul;
+
+// every worker takes part in every job, even if there are no ranges left for
+// it, so the job can't be overwritten while a worker is still reading it
+struct WorkerPool {
+  std::vector<std::thread> workers;
+
+  std::mutex mutex;
+  std::condition_variable jobBegin;
+  std::condition_variable jobEnd;
+
+  size_t generation = 0ul;
+  size_t workersDone = 0ul;
+  bool shutdown = false;
+
+  // -- current job, only written while no worker is processing it
+  void (*fn)(void const *, size_t, size_t) = nullptr;
+  void const * userdata = nullptr;
+  size_t count = 0ul;
+  size_t rangeSize = 0ul;
+  size_t rangeCount = 0ul;
+  std::atomic<size_t> nextRange = 0ul;
+
+  WorkerPool();
+  ~WorkerPool();
+
+  void ProcessRanges();
+  void WorkerLoop(size_t workerIdx);
+};
+
+WorkerPool::WorkerPool() {
+  size_t const hardwareThreads =
+    std::max(std::thread::hardware_concurrency(), 1u);
+
+  // leave a core for the calling thread, which also processes ranges
+  size_t const workerCount =
+    std::min(hardwareThreads, pul::util::maxParallelThreads) - 1ul;
+
+  workers.reserve(workerCount);
+  for (size_t it = 0ul; it < workerCount; ++ it)
+    { workers.emplace_back([this, it]() { this->WorkerLoop(it); }); }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    shutdown = true;
+  }
+  jobBegin.notify_all();
+
+  for (auto & worker : workers)
+    { worker.join(); }
+}
+
+void WorkerPool::ProcessRanges() {
+  for (;;) {
+    size_t const range = nextRange.fetch_add(1ul);
+    if (range >= rangeCount) { return; }
+
+    size_t const begin = range*rangeSize;
+    fn(userdata, begin, std::min(begin + rangeSize, count));
+  }
+}
+
+void WorkerPool::WorkerLoop(size_t const workerIdx) {
+  ::parallelWorkerIdx = workerIdx + 1ul;
+
+  size_t workerGeneration = 0ul;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      jobBegin.wait(
+        lock
+      , [&]() { return shutdown || generation != workerGeneration; }
+      );
+
+      if (shutdown) { return; }
+
+      workerGeneration = generation;
+    }
+
+    this->ProcessRanges();
+
+    bool jobDone;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      jobDone = (++ workersDone == workers.size());
+    }
+
+    if (jobDone) { jobEnd.notify_one(); }
+  }
+}
+
+WorkerPool & Pool() {
+  static WorkerPool pool;
+  return pool;
+}
+
+} // -- namespace
+
+size_t pul::util::ParallelThreadCount() {
+  return ::Pool().workers.size() + 1ul;
+}
+
+size_t pul::util::ParallelWorkerIdx() {
+  return ::parallelWorkerIdx;
+}
+
+void pul::util::ParallelForRanges(
+  size_t const count, size_t const minRangeSize
+, void (*fn)(void const * userdata, size_t begin, size_t end)
+, void const * userdata
+) {
+  if (count == 0ul) { return; }
+
+  auto & pool = ::Pool();
+
+  // a few ranges per thread to balance out uneven ranges
+  size_t const rangeSize =
+    std::max(
+      std::max(minRangeSize, 1ul)
+    , (count + (pool.workers.size()+1ul)*4ul - 1ul)
+    / ((pool.workers.size()+1ul)*4ul)
+    );
+
+  size_t const rangeCount = (count + rangeSize - 1ul) / rangeSize;
+
+  // not worth waking up the workers
+  if (rangeCount == 1ul || pool.workers.size() == 0ul) {
+    fn(userdata, 0ul, count);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    pool.fn = fn;
+    pool.userdata = userdata;
+    pool.count = count;
+    pool.rangeSize = rangeSize;
+    pool.rangeCount = rangeCount;
+    pool.nextRange = 0ul;
+    pool.workersDone = 0ul;
+    ++ pool.generation;
+  }
+  pool.jobBegin.notify_all();
+
+  pool.ProcessRanges();
+
+  std::unique_lock<std::mutex> lock(pool.mutex);
+  pool.jobEnd.wait(
+    lock, [&pool]() { return pool.workersDone == pool.workers.size(); }
+  );
+}
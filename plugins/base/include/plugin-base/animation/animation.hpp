@@ -7,9 +7,10 @@
 namespace pul::core { struct SceneBundle; }
 
 namespace plugin::animation {
+  // evaluates the skeletal matrices of every piece, in a single pass over the
+  // animator's flattened skeleton
   void ComputeCache(
     pul::animation::Instance & instance
-  , std::vector<pul::animation::Animator::SkeletalPiece> const & skeletals
   , glm::mat3 const skeletalMatrix
   , bool const skeletalFlip
   , float const skeletalRotation
@@ -20,6 +21,16 @@ namespace plugin::animation {
   , bool forceUpdate = false
   );
 
+  // advances the timeline of every piece by a frame, same as ComputeVertices
+  // would, without computing vertices
+  void AdvanceTimeline(pul::animation::Instance & instance);
+
+  // whether the instance is visible & within the camera bounds
+  bool IsVisible(
+    pul::core::SceneBundle const & scene
+  , pul::animation::Instance const & instance
+  );
+
   void LoadAnimations(
     pul::core::SceneBundle & scene
   );
@@ -2,8 +2,8 @@
 
 #include <pulcher-animation/animation.hpp>
 
+#include <memory>
 #include <vector>
-#include <unordered_map>
 
 namespace pul::animation { struct Instance; }
 namespace pul::core { struct RenderBundleInstance; }
@@ -11,26 +11,80 @@ namespace pul::core { struct SceneBundle; }
 
 namespace plugin::animation {
 
-  struct Interpolant {
-    pul::animation::Instance instance;
+  // POD copy of the piece state needed to re-evaluate an instance's skeleton,
+  // except for the angle, see AnimationSnapshot::pieceAngles. These fields
+  // are only read from one of the snapshots & copied together into the
+  // evaluated state, so they're kept together
+  struct PieceSnapshot {
+    glm::mat3 cachedLocalSkeletalMatrix;
+    glm::mat3 cachedSkeletalMatrix;
+    pul::animation::Instance::StateInfo::CachedInputs cachedInputs;
+    pul::animation::VariationRuntimeInfo variationRti;
+    glm::vec2 uvCoordWrap;
+    glm::vec2 vertWrap;
+    size_t stateIdx;
+    size_t componentIt;
+    float deltaTime;
+    bool flip;
+    bool visible;
+    bool animationFinished;
+    bool flipVertWrap;
   };
-}
 
-template <typename... T>
-using InterpolantMap = std::unordered_map<size_t, T...>;
+  // render state of every visible instance for a single logic frame. Two of
+  // these are kept & swapped every frame, so they keep their capacity and
+  // don't allocate once warmed up
+  struct AnimationSnapshot {
+    // -- per instance, sorted by entity
+    std::vector<size_t> entities;
+    // shared, so an animator the editor replaces outlives its snapshots
+    std::vector<std::shared_ptr<pul::animation::Animator>> animators;
+    // the animator's compile generation & the instance's piece count when it
+    // was recorded; Interpolate only evaluates pieces that still match
+    std::vector<size_t> compileGenerations;
+    std::vector<size_t> pieceCounts;
+    std::vector<glm::vec2> origins;
+    std::vector<bool> hasCalculatedCachedInfo;
+    std::vector<pul::animation::Instance::CachedRoot> cachedRoots;
+    std::vector<size_t> pieceOffsets; // into the per piece arrays
 
-namespace plugin::animation {
+    // -- per piece, indexed by offset + piece idx. The angle is the only one
+    //    read from both snapshots, so it has its own array
+    std::vector<PieceSnapshot> pieces;
+    std::vector<float> pieceAngles;
+
+    void Clear();
+
+    void Record(size_t entity, pul::animation::Instance const & instance);
+  };
+
+  // interpolated vertices of every instance for a single render frame
+  struct AnimationRenderOutput {
+    // -- per instance
+    std::vector<pul::animation::Animator const *> animators;
+    std::vector<glm::vec2> origins;
+    std::vector<size_t> vertexOffsets; // into the vertex buffers
+
+    // -- per vertex
+    std::vector<glm::vec2> uvCoordBufferData;
+    std::vector<glm::vec3> originBufferData;
+
+    void Clear();
+  };
 
   void RenderInterpolated(
     pul::core::SceneBundle const & scene
   , pul::core::RenderBundleInstance const & interpolatedBundle
-  , std::vector<plugin::animation::Interpolant> const & instancesCurrent
+  , AnimationRenderOutput const & output
   );
 
   void Interpolate(
     const float msDeltaInterp
-  , InterpolantMap<plugin::animation::Interpolant> const & instancesPrevious
-  , InterpolantMap<plugin::animation::Interpolant> const & instancesCurrent
-  , std::vector<plugin::animation::Interpolant> & instancesOutput
+  , AnimationSnapshot const & snapshotPrevious
+  , AnimationSnapshot const & snapshotCurrent
+  , AnimationRenderOutput & output
   );
+
+  // releases the buffers Interpolate keeps around between frames
+  void ReleaseInterpolationScratch();
 }
@@ -70,6 +70,7 @@ namespace plugin::config {
   namespace pericaliya::primary {
     int32_t & DischargeCooldown();
     float & ProjectileVelocity();
+    int32_t & ProjectileCollisionRadius();
     int32_t & ProjectileExplosionRadius();
     float & ProjectileExplosionForce();
     int32_t & ProjectileSplashDamageMin();
@@ -266,6 +266,14 @@ namespace plugin::entity {
     glm::vec2 origin = {};
   };
 
+  // records direct damage on the entity, returns false if it isn't damageable
+  bool WeaponDamageEntity(
+    pul::core::SceneBundle & scene
+  , entt::entity entity
+  , glm::vec2 const & direction
+  , float const damage, float const force
+  );
+
   WeaponDamageRaycastReturnInfo WeaponDamageRaycast(
     pul::core::SceneBundle & scene
   , glm::vec2 const & originBegin, glm::vec2 const & originEnd
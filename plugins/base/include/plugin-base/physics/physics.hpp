@@ -1,5 +1,7 @@
 #pragma once
 
+#include <pulcher-physics/intersections.hpp>
+
 #include <span>
 #include <vector>
 
@@ -9,21 +11,45 @@ namespace pul::core { enum class TileOrientation : size_t; }
 namespace pul::core { struct SceneBundle; }
 namespace pul::gfx { struct Image; }
 namespace pul::physics { struct EntityIntersectionResults; }
+namespace pul::physics { struct EntityRaycastHit; }
 namespace pul::physics { struct IntersectionResults; }
 namespace pul::physics { struct IntersectorAabb; }
 namespace pul::physics { struct IntersectorCircle; }
+namespace pul::physics { struct IntersectorEntityRay; }
 namespace pul::physics { struct IntersectorPoint; }
 namespace pul::physics { struct IntersectorRay; }
-namespace pul::physics { struct TilemapLayer; }
+namespace pul::physics { struct IntersectorSweptAabb; }
+namespace pul::physics { struct IntersectorSweptCircle; }
+namespace pul::physics { struct PhysicsWorld; }
+namespace pul::physics { struct SweptCircleIntersectionResults; }
+namespace pul::physics { struct SweptIntersectionResults; }
 namespace pul::physics { struct Tileset; }
 
 namespace plugin::physics {
+  // rebuilds the spatial hash used by the entity queries, once per logic tick
+  // before entities are updated
+  void UpdateEntityBroadphase(pul::core::SceneBundle & scene);
+
   void EntityIntersectionRaycast(
     pul::core::SceneBundle & scene
   , pul::physics::IntersectorRay const & ray
   , pul::physics::EntityIntersectionResults & intersectionResults
   );
 
+  // the nearest hits.size() entity hits along the ray, nearest first, written
+  // to the caller's buffer without allocating. With stopAtLayer the layer
+  // contact is written to layerResults and nothing behind it is hit. Returns
+  // the amount of hits written
+  size_t EntityIntersectionRaycastSorted(
+    pul::physics::PhysicsWorld const &
+  , pul::core::SceneBundle & scene
+  , pul::physics::IntersectorEntityRay const & intersector
+  , std::span<pul::physics::EntityRaycastHit> hits
+  , pul::physics::IntersectionResults & layerResults
+  );
+
+  // every entity hit; reusing intersectionResults across calls keeps the
+  // capacity of its entity list, so steady state queries don't allocate
   void EntityIntersectionCircle(
     pul::core::SceneBundle & scene
   , pul::physics::IntersectorCircle const & circle
@@ -35,8 +61,31 @@ namespace plugin::physics {
   , pul::gfx::Image const & image
   );
 
+  // ProcessTileset, but reuses the result cached in cacheDirectory when it
+  // was processed from an identical image file, and caches it otherwise.
+  // Cache files are named after the hash of the file bytes
+  void LoadTileset(
+    pul::physics::Tileset & tileset
+  , pul::gfx::Image const & image
+  , char const * cacheDirectory
+  );
+
+  // releases the query scratch & broadphase buffers
+  void Shutdown();
+
   void ClearMapGeometry();
 
+  // streams a chunk of the collision layer in, replacing the chunk at the same
+  // origin (in chunks). tileInfo holds chunkTiles*chunkTiles tiles row by
+  // row, indexing the tilesets the map was loaded with. Must not be called
+  // while queries run
+  void LoadMapChunk(
+    glm::i32vec2 chunkOrigin
+  , std::span<pul::physics::TilemapLayer::TileInfo const> tileInfo
+  );
+
+  void UnloadMapChunk(glm::i32vec2 chunkOrigin);
+
   void LoadMapGeometry(
     std::vector<pul::physics::Tileset const *> const & tilesets
   , std::vector<std::span<size_t>>             const & mapTileIndices
@@ -45,7 +94,7 @@ namespace plugin::physics {
   );
 
   bool InverseSceneIntersectionRaycast(
-    pul::core::SceneBundle &
+    pul::physics::PhysicsWorld const &
   , pul::physics::IntersectorRay const & ray
   , pul::physics::IntersectionResults & intersectionResults
   );
@@ -59,21 +108,51 @@ namespace plugin::physics {
   void SimulatePhysics();
 
   bool IntersectionRaycast(
-    pul::core::SceneBundle &
+    pul::physics::PhysicsWorld const &
   , pul::physics::IntersectorRay const & ray
   , pul::physics::IntersectionResults & intersectionResults
   );
 
-  pul::physics::TilemapLayer * TilemapLayer();
+  // traces every ray against the collision layer. Tiles & chunks are resolved
+  // once per batch and shared between its rays, so bundles of rays close to
+  // each other are cheaper than as many IntersectionRaycast. Returns true if
+  // any of the rays collided
+  bool IntersectionRaycastBatch(
+    pul::physics::PhysicsWorld const &
+  , std::span<pul::physics::IntersectorRay const> rays
+  , std::span<pul::physics::IntersectionResults> intersectionResults
+  );
+
+  // earliest contact of the moving aabb with the collision layer, texels the
+  // aabb already overlaps at the start of the sweep are ignored
+  bool IntersectionSweptAabb(
+    pul::physics::PhysicsWorld const &
+  , pul::physics::IntersectorSweptAabb const & sweep
+  , pul::physics::SweptIntersectionResults & intersectionResults
+  );
+
+  // earliest contact of the moving circle with either the collision layer or
+  // an entity hitbox, in a single pass; entities are only searched up to the
+  // tile contact. Meant for projectiles, so fast ones can't tunnel through
+  // thin hitboxes
+  bool IntersectionSweptCircle(
+    pul::physics::PhysicsWorld const &
+  , pul::core::SceneBundle & scene
+  , pul::physics::IntersectorSweptCircle const & sweep
+  , pul::physics::SweptCircleIntersectionResults & intersectionResults
+  );
+
+  // tile queries only read the world, see IntersectionRaycast etc
+  pul::physics::PhysicsWorld const & World();
 
   bool IntersectionAabb(
-    pul::core::SceneBundle &
+    pul::physics::PhysicsWorld const &
   , pul::physics::IntersectorAabb const &
   , pul::physics::IntersectionResults &
   );
 
   bool IntersectionPoint(
-    pul::core::SceneBundle &
+    pul::physics::PhysicsWorld const &
   , pul::physics::IntersectorPoint const & point
   , pul::physics::IntersectionResults & intersectionResults
   );
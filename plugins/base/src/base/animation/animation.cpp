@@ -1,5 +1,6 @@
 #include <plugin-base/animation/animation.hpp>
 
+#include <plugin-base/animation/render.hpp>
 #include <pulcher-animation/animation.hpp>
 #include <pulcher-core/scene-bundle.hpp>
 #include <pulcher-gfx/context.hpp>
@@ -9,6 +10,7 @@
 #include <pulcher-util/consts.hpp>
 #include <pulcher-util/enum.hpp>
 #include <pulcher-util/log.hpp>
+#include <pulcher-util/parallel.hpp>
 #include <pulcher-util/random.hpp>
 
 #include <cjson/cJSON.h>
@@ -18,6 +20,8 @@
 #include <imgui/imgui.hpp>
 #include <sokol/gfx.hpp>
 
+#include <algorithm>
+#include <array>
 #include <fstream>
 
 // animation could always use cleaning / optimizing as a lot of it isn't based
@@ -199,14 +203,43 @@ cJSON * JsonWriteRecursiveSkeleton(
   return skeletalsJson;
 }
 
-size_t ComputeVertexBufferSize(
-  std::vector<pul::animation::Animator::SkeletalPiece> const & skeletals
+size_t ComputeVertexBufferSize(pul::animation::Animator const & animator) {
+  return animator.flatSkeleton.size() * 6ul;
+}
+
+// what a skeletal piece passes on to its children, per piece of the flattened
+// skeleton; one buffer per ParallelFor thread as instances can be evaluated
+// concurrently
+struct SkeletalState {
+  glm::mat3 matrix;
+  bool flip;
+  float rotation;
+  bool dirty; // the matrix changed since the last ComputeCache
+};
+
+std::array<std::vector<SkeletalState>, pul::util::maxParallelThreads>
+  threadSkeletalStates;
+
+std::vector<SkeletalState> & LocalSkeletalStates(size_t const pieceCount) {
+  auto & states = ::threadSkeletalStates[pul::util::ParallelWorkerIdx()];
+  states.resize(pieceCount);
+  return states;
+}
+
+// instances to update in UpdateFrame
+std::vector<pul::animation::Instance *> updateInstances;
+
+// initial state of each skeletal piece, which is its parent's state
+SkeletalState & InheritSkeletalState(
+  std::vector<SkeletalState> & states
+, pul::animation::Animator::FlatSkeletalPiece const & skeletal
+, size_t const skeletalIdx
+, SkeletalState const & rootState
 ) {
-  size_t vertices = 0ul;
-  for (const auto & skeletal : skeletals) {
-    vertices += 6 + ComputeVertexBufferSize(skeletal.children);
-  }
-  return vertices;
+  auto & state = states[skeletalIdx];
+  state =
+    skeletal.parentIdx == -1ul ? rootState : states[skeletal.parentIdx];
+  return state;
 }
 
 // used to compute generic animation info necessary for computing vertices and
@@ -219,15 +252,18 @@ std::tuple<
 , std::vector<pul::animation::Component> *
 > ComputeAnimationInfo(
   pul::animation::Instance & instance
-, pul::animation::Animator::SkeletalPiece const & skeletal
+, pul::animation::Animator::FlatSkeletalPiece const & skeletal
 , bool & skeletalFlip
 , float & skeletalRotation
 ) {
-  // okay the below is crazy with the map lookups, I need to cache the
-  // state somehow
-  auto & piece     = instance.animator->pieces[skeletal.label];
-  auto & stateInfo = instance.pieceToState[skeletal.label];
-  auto & state     = piece.states[stateInfo.label];
+  // pieces without states use an empty state, which has no components
+  static pul::animation::Animator::State emptyState = {};
+
+  auto & piece     = *instance.animator->pieceByIdx[skeletal.pieceIdx];
+  auto & stateInfo = instance.pieceStates[skeletal.pieceIdx];
+  auto & state     =
+    stateInfo.stateIdx == -1ul
+  ? emptyState : *piece.stateByIdx[stateInfo.stateIdx];
 
   // update skeletal information (origins, flip, rotation, etc)
   skeletalFlip ^= stateInfo.flip;
@@ -253,42 +289,16 @@ std::tuple<
   return { piece, stateInfo, state, componentsPtr };
 }
 
-void ComputeVertices(
-  pul::animation::Instance & instance
-, pul::animation::Animator::SkeletalPiece const & skeletal
-, size_t & indexOffset
-, bool & skeletalFlip
-, float & skeletalRotation
-, bool & forceUpdate
+// steps the piece's current component by a frame, returns true if the
+// component changed
+bool StepComponent(
+  pul::animation::Instance::StateInfo & stateInfo
+, pul::animation::Animator::State & state
+, std::vector<pul::animation::Component> & components
 ) {
-  auto const & [piece, stateInfo, state, componentsPtr] =
-    ComputeAnimationInfo(instance, skeletal, skeletalFlip, skeletalRotation);
-
-  // if there are no components to render, output a degenerate tile
-  if (!componentsPtr || componentsPtr->size() == 0ul) {
-    for (size_t it = 0ul; it < 6ul; ++ it) {
-      instance.uvCoordBufferData[indexOffset + it] = glm::vec2(-1);
-      instance.originBufferData[indexOffset + it] = glm::vec3(-1);
-    }
-
-    indexOffset += 6ul;
-    return;
-  }
-
-  auto & components = *componentsPtr;
-
-  PUL_ASSERT_CMP(components.size(), >, 0ul, return;);
-
-  PUL_ASSERT_CMP(
-    stateInfo.componentIt, <, components.size()
-  , stateInfo.componentIt = components.size()-1;
-  );
-
   auto & component = components[stateInfo.componentIt];
 
-  // update delta time and if animation update is necessary, apply uv coord
-  // updates
-  bool hasUpdate = forceUpdate;
+  bool hasUpdate = false;
   float const msDeltaTime = state.MsDeltaTime(component);
 
   if (msDeltaTime > 0.0f && !stateInfo.animationFinished) {
@@ -299,13 +309,12 @@ void ComputeVertices(
         stateInfo.componentIt = (stateInfo.componentIt + 1) % components.size();
         hasUpdate = true;
 
-        // 'respin' random variation
+        // 'respin' random variation, see RespinVariations
         if (
             stateInfo.componentIt == 0
          && state.variationType == pul::animation::VariationType::Random
         ) {
-          stateInfo.variationRti.random.idx =
-            pul::util::RandomInt32(0, state.variations.size()-1);
+          stateInfo.variationRespin = true;
         }
       } else {
         if (stateInfo.componentIt < components.size()-1) {
@@ -320,42 +329,105 @@ void ComputeVertices(
     }
   }
 
-  if (!hasUpdate) {
-    indexOffset += 6ul;
+  return hasUpdate;
+}
+
+// re-rolls the random variations flagged by StepComponent; called serially in
+// the order of the instances so the random sequence doesn't depend on how
+// ParallelFor scheduled them
+void RespinVariations(pul::animation::Instance & instance) {
+  for (auto & stateInfo : instance.pieceStates) {
+    if (!stateInfo.variationRespin) { continue; }
+    stateInfo.variationRespin = false;
+
+    auto const & piece = *instance.animator->pieceByIdx[stateInfo.pieceIdx];
+    auto const & state = *piece.stateByIdx[stateInfo.stateIdx];
+
+    stateInfo.variationRti.random.idx =
+      pul::util::RandomInt32(0, state.variations.size()-1);
+  }
+}
+
+void ComputeVertices(
+  pul::animation::Instance & instance
+, pul::animation::Animator::FlatSkeletalPiece const & skeletal
+, size_t indexOffset
+, bool & skeletalFlip
+, float & skeletalRotation
+, bool const forceUpdate
+) {
+  auto const & [piece, stateInfo, state, componentsPtr] =
+    ComputeAnimationInfo(instance, skeletal, skeletalFlip, skeletalRotation);
+
+  // if there are no components to render, output a degenerate tile
+  if (!componentsPtr || componentsPtr->size() == 0ul) {
+    for (size_t it = 0ul; it < 6ul; ++ it) {
+      instance.uvCoordBufferData[indexOffset + it] = glm::vec2(-1);
+      instance.originBufferData[indexOffset + it] = glm::vec3(-1);
+    }
+
     return;
   }
 
+  auto & components = *componentsPtr;
+
+  PUL_ASSERT_CMP(components.size(), >, 0ul, return;);
+
+  PUL_ASSERT_CMP(
+    stateInfo.componentIt, <, components.size()
+  , stateInfo.componentIt = components.size()-1;
+  );
+
+  auto & component = components[stateInfo.componentIt];
+
+  // update delta time and if animation update is necessary, apply uv coord
+  // updates
+  bool const hasUpdate =
+    ::StepComponent(stateInfo, state, components) || forceUpdate;
+
+  if (!hasUpdate) { return; }
+
   auto pieceDimensions = glm::vec2(piece.dimensions);
 
-  // update origins & UV coords
+  bool const uvFlip = skeletalFlip ^ state.flipXAxis;
+
+  // uv coords are compiled with the animator, unless they're clipped/wrapped
+  if (stateInfo.uvCoordWrap == glm::vec2(1.0f)) {
+    std::copy(
+      component.uvCoords[uvFlip].begin(), component.uvCoords[uvFlip].end()
+    , instance.uvCoordBufferData.begin() + indexOffset
+    );
+  } else {
+    auto const invResolution = instance.animator->spritesheet.InvResolution();
+    for (size_t it = 0ul; it < 6; ++ it) {
+      auto uv = pul::util::TriangleVertexArray()[it];
+
+      // apply uv clipping/wrapping if requested (non 1.0 value)
+      uv *= stateInfo.uvCoordWrap;
+
+      // flip uv coords if requested
+      if (uvFlip) { uv.x = 1.0f - uv.x; }
+
+      instance.uvCoordBufferData[indexOffset + it] =
+        (
+            (uv*pieceDimensions + glm::vec2(component.tile)*pieceDimensions)
+          + glm::vec2(instance.animator->uvCoordOffset)
+        )
+        * invResolution
+      ;
+    }
+  }
+
+  // update origins
   for (size_t it = 0ul; it < 6; ++ it, ++ indexOffset) {
     auto v = pul::util::TriangleVertexArray()[it];
-    auto uv = v;
 
-    auto uvCoordWrap = stateInfo.uvCoordWrap;
-    /* if (state.flipXAxis) { uvCoordWrap = 1.0f - uvCoordWrap; } */
-    /* if (skeletalFlip)    { uvCoordWrap = 1.0f - uvCoordWrap; } */
-
-    // apply uv clipping/wrapping if requested (non 1.0 value)
-    uv *= uvCoordWrap;
-    v  *= stateInfo.vertWrap;
+    v *= stateInfo.vertWrap;
 
     if (stateInfo.flipVertWrap) {
       v = glm::vec2(1.0f) - v;
     }
 
-    // flip uv coords if requested
-    if (skeletalFlip) { uv.x = 1.0f - uv.x; }
-
-    if (state.flipXAxis) { uv.x = 1.0f - uv.x; }
-
-    instance.uvCoordBufferData[indexOffset] =
-      (
-          (uv*pieceDimensions + glm::vec2(component.tile)*pieceDimensions)
-        + glm::vec2(instance.animator->uvCoordOffset)
-      )
-      * instance.animator->spritesheet.InvResolution()
-    ;
     auto origin = glm::vec3(v*pieceDimensions, 1.0f);
 
     origin = stateInfo.cachedLocalSkeletalMatrix * origin;
@@ -369,54 +441,47 @@ void ComputeVertices(
   }
 }
 
-void ComputeVertices(
-  pul::animation::Instance & instance
-, std::vector<pul::animation::Animator::SkeletalPiece> const & skeletals
-, size_t & indexOffset
-, bool const skeletalFlip
-, float const skeletalRotation
-, bool const forceUpdate
-) {
-  for (auto const & skeletal : skeletals) {
-    // compute origin / uv coords
-    bool newSkeletalFlip = skeletalFlip;
-    float newSkeletalRotation = skeletalRotation;
-    bool newForceUpdate = forceUpdate;
-    ComputeVertices(
-      instance, skeletal, indexOffset
-    , newSkeletalFlip, newSkeletalRotation, newForceUpdate
-    );
-
-    // continue to children
-    ComputeVertices(
-      instance, skeletal.children, indexOffset
-    , newSkeletalFlip, newSkeletalRotation, newForceUpdate
-    );
-  }
-}
-
 void ComputeCache(
   pul::animation::Instance & instance
-, pul::animation::Animator::SkeletalPiece const & skeletal
+, pul::animation::Animator::FlatSkeletalPiece const & skeletal
 , glm::mat3 & skeletalMatrix
 , bool & skeletalFlip
 , float & skeletalRotation
+, bool & dirty
 ) {
-  if (instance.hasCalculatedCachedInfo) { return; }
-
-
   auto const & [piece, stateInfo, state, componentsPtr] =
     ComputeAnimationInfo(instance, skeletal, skeletalFlip, skeletalRotation);
 
-  if (!componentsPtr || componentsPtr->size() == 0ul) { return; }
+  if (componentsPtr && componentsPtr->size() > 0ul) {
+    PUL_ASSERT_CMP(
+      stateInfo.componentIt, <, componentsPtr->size()
+    , stateInfo.componentIt = componentsPtr->size()-1;
+    );
+  }
 
-  auto & components = *componentsPtr;
+  // -- only recompute if the inputs have changed, the angle & flip are also
+  //    passed down to the children so they are tracked regardless
+  auto const inputs =
+    pul::animation::Instance::StateInfo::CachedInputs {
+      .components = componentsPtr
+    , .componentIt = stateInfo.componentIt
+    , .angle = stateInfo.angle
+    , .deltaTime = state.originInterpolates ? stateInfo.deltaTime : 0.0f
+    , .flip = stateInfo.flip
+    };
 
-  PUL_ASSERT_CMP(
-    stateInfo.componentIt, <, components.size()
-  , stateInfo.componentIt = components.size()-1;
-  );
+  dirty = dirty || !(inputs == stateInfo.cachedInputs);
+  stateInfo.cachedInputs = inputs;
+
+  // without components the matrix is passed through as is
+  if (!componentsPtr || componentsPtr->size() == 0ul) { return; }
+
+  if (!dirty) {
+    skeletalMatrix = stateInfo.cachedSkeletalMatrix;
+    return;
+  }
 
+  auto & components = *componentsPtr;
   auto & component = components[stateInfo.componentIt];
 
   // -- compose skeletal matrix
@@ -491,28 +556,46 @@ void ComputeCache(
     skeletalMatrix =
       glm::translate(skeletalMatrix, glm::vec2(localOrigin));
    }
+
+  stateInfo.cachedSkeletalMatrix = skeletalMatrix;
 }
 } // -- namespace
 
 void plugin::animation::ComputeCache(
   pul::animation::Instance & instance
-, std::vector<pul::animation::Animator::SkeletalPiece> const & skeletals
 , glm::mat3 const skeletalMatrix
 , bool const skeletalFlip
 , float const skeletalRotation
 ) {
-  for (auto const & skeletal : skeletals) {
-    auto newSkeletalMatrix = skeletalMatrix;
-    auto newSkeletalFlip = skeletalFlip;
-    auto newSkeletalRotation = skeletalRotation;
-    ::ComputeCache(
-      instance, skeletal
-    , newSkeletalMatrix, newSkeletalFlip, newSkeletalRotation
-    );
+  if (instance.hasCalculatedCachedInfo) { return; }
+
+  // a piece is only recomputed if its inputs changed, or if the matrix it
+  // inherits did; otherwise its cached matrices are reused
+  auto const root =
+    pul::animation::Instance::CachedRoot {
+      .skeletalMatrix = skeletalMatrix
+    , .skeletalRotation = skeletalRotation
+    , .skeletalFlip = skeletalFlip
+    , .valid = true
+    };
+
+  bool const rootDirty = !(root == instance.cachedRoot);
+  instance.cachedRoot = root;
 
-    plugin::animation::ComputeCache(
-      instance, skeletal.children
-    , newSkeletalMatrix, newSkeletalFlip, newSkeletalRotation
+  auto const & flatSkeleton = instance.animator->flatSkeleton;
+  auto & skeletalStates = ::LocalSkeletalStates(flatSkeleton.size());
+
+  auto const rootState =
+    ::SkeletalState {
+      skeletalMatrix, skeletalFlip, skeletalRotation, rootDirty
+    };
+
+  for (size_t it = 0ul; it < flatSkeleton.size(); ++ it) {
+    auto & state =
+      ::InheritSkeletalState(skeletalStates, flatSkeleton[it], it, rootState);
+    ::ComputeCache(
+      instance, flatSkeleton[it]
+    , state.matrix, state.flip, state.rotation, state.dirty
     );
   }
 }
@@ -521,18 +604,84 @@ void plugin::animation::ComputeVertices(
   pul::animation::Instance & instance
 , bool forceUpdate
 ) {
-  size_t indexOffset = 0ul;
-  ::ComputeVertices(
-    instance, instance.animator->skeleton
-  , indexOffset, false, 0.0f, forceUpdate
-  );
+  auto const & flatSkeleton = instance.animator->flatSkeleton;
+  auto & skeletalStates = ::LocalSkeletalStates(flatSkeleton.size());
+
+  auto const rootState =
+    ::SkeletalState { glm::mat3(1.0f), false, 0.0f, false };
+
+  for (size_t it = 0ul; it < flatSkeleton.size(); ++ it) {
+    auto & state =
+      ::InheritSkeletalState(skeletalStates, flatSkeleton[it], it, rootState);
+    ::ComputeVertices(
+      instance, flatSkeleton[it], it*6ul, state.flip, state.rotation
+    , forceUpdate
+    );
+  }
+}
+
+void plugin::animation::AdvanceTimeline(pul::animation::Instance & instance) {
+  auto const & flatSkeleton = instance.animator->flatSkeleton;
+  auto & skeletalStates = ::LocalSkeletalStates(flatSkeleton.size());
+
+  // the component depends on the flip & rotation inherited from the skeleton
+  auto const rootState =
+    ::SkeletalState { glm::mat3(1.0f), false, 0.0f, false };
+
+  for (size_t it = 0ul; it < flatSkeleton.size(); ++ it) {
+    auto & skeletalState =
+      ::InheritSkeletalState(skeletalStates, flatSkeleton[it], it, rootState);
+
+    auto const & [piece, stateInfo, state, componentsPtr] =
+      ::ComputeAnimationInfo(
+        instance, flatSkeleton[it], skeletalState.flip, skeletalState.rotation
+      );
+
+    if (!componentsPtr || componentsPtr->size() == 0ul) { continue; }
+
+    PUL_ASSERT_CMP(
+      stateInfo.componentIt, <, componentsPtr->size()
+    , stateInfo.componentIt = componentsPtr->size()-1;
+    );
+
+    ::StepComponent(stateInfo, state, *componentsPtr);
+  }
+}
+
+bool plugin::animation::IsVisible(
+  pul::core::SceneBundle const & scene
+, pul::animation::Instance const & instance
+) {
+  auto cameraOrigin = glm::vec2(scene.cameraOrigin);
+  auto const
+    cullBoundLeft  = cameraOrigin.x - scene.config.framebufferDimFloat.x/2.0f
+  , cullBoundRight = cameraOrigin.x + scene.config.framebufferDimFloat.x/2.0f
+  , cullBoundUp    = cameraOrigin.y - scene.config.framebufferDimFloat.y/2.0f
+  , cullBoundDown  = cameraOrigin.y + scene.config.framebufferDimFloat.y/2.0f
+  ;
+
+  // check if visible / cull / ready to render
+  return
+      instance.visible
+   && instance.drawCallCount != 0ul
+   && cullBoundLeft  <= instance.origin.x
+   && cullBoundRight >= instance.origin.x
+   && cullBoundUp    <= instance.origin.y
+   && cullBoundDown  >= instance.origin.y
+  ;
 }
 
 namespace {
 
+// recompiles the animators after they've been edited, instances are rebuilt
+// as their piece & state indices could have changed
 void ReconstructInstances(pul::core::SceneBundle & scene) {
   auto & registry = scene.EnttRegistry();
   auto & system = scene.AnimationSystem();
+
+  for (auto & animatorPair : system.animators)
+    { animatorPair.second->Compile(); }
+
   auto view = registry.view<pul::animation::ComponentInstance>();
   for (auto entity : view) {
     auto & self = view.get<pul::animation::ComponentInstance>(entity);
@@ -823,7 +972,8 @@ void DisplayImGuiSkeleton(
       continue;
     }
 
-    pul::imgui::DragInt2("origin", &skeletal.origin.x, 0.025f);
+    if (pul::imgui::DragInt2("origin", &skeletal.origin.x, 0.025f))
+      { animator.Compile(); }
 
     if (ImGui::Button("remove")) {
       skeletals.erase(skeletals.begin() + skeletalIdx);
@@ -1283,6 +1433,8 @@ void LoadAnimation(
 
     // load skeleton
     ::JsonParseRecursiveSkeleton(sheetJson, animator->skeleton);
+
+    animator->Compile();
   }
 
   cJSON_Delete(fileDataJson);
@@ -1484,30 +1636,58 @@ void plugin::animation::Shutdown(pul::core::SceneBundle & scene) {
   sg_destroy_pipeline(scene.AnimationSystem().sgPipeline);
 
   scene.AnimationSystem() = {};
+
+  ::threadSkeletalStates = {};
+  ::updateInstances = {};
+  plugin::animation::ReleaseInterpolationScratch();
 }
 
 void plugin::animation::UpdateFrame(pul::core::SceneBundle & scene) {
   auto & registry = scene.EnttRegistry();
-  // update each component
+
+  ::updateInstances.clear();
+
   auto view = registry.view<pul::animation::ComponentInstance>();
   for (auto entity : view) {
     auto & self = view.get<pul::animation::ComponentInstance>(entity);
+    ::updateInstances.emplace_back(&self.instance);
+  }
 
-    plugin::animation::ComputeCache(
-      self.instance, self.instance.animator->skeleton
-    , glm::mat3(1.0f), false, 0.0f
-    );
+  // update each component; instances only read their animator, so they can
+  // be updated independently of each other
+  pul::util::ParallelFor(
+    ::updateInstances.size(), 16ul
+  , [&scene](size_t const begin, size_t const end) {
+      for (size_t it = begin; it < end; ++ it) {
+        auto & instance = *::updateInstances[it];
 
-    plugin::animation::ComputeVertices(self.instance, true);
-  }
+        // instances that won't be rendered this frame & aren't queried by
+        // gameplay only need to keep their timeline going
+        if (
+            !instance.alwaysComputeCachedMatrix
+         && !plugin::animation::IsVisible(scene, instance)
+        ) {
+          plugin::animation::AdvanceTimeline(instance);
+          continue;
+        }
+
+        plugin::animation::ComputeCache(
+          instance, glm::mat3(1.0f), false, 0.0f
+        );
+
+        plugin::animation::ComputeVertices(instance, true);
+      }
+    }
+  );
+
+  for (auto * instance : ::updateInstances)
+    { ::RespinVariations(*instance); }
 }
 
 void plugin::animation::UpdateCache(
   pul::animation::Instance & instance
 ) {
-  plugin::animation::ComputeCache(
-    instance, instance.animator->skeleton, glm::mat3(1.0f), false, 0.0f
-  );
+  plugin::animation::ComputeCache(instance, glm::mat3(1.0f), false, 0.0f);
   instance.hasCalculatedCachedInfo = true;
 }
 
@@ -1515,9 +1695,7 @@ void plugin::animation::UpdateCacheWithPrecalculatedMatrix(
   pul::animation::Instance & instance
 , glm::mat3 const & skeletalMatrix
 ) {
-  plugin::animation::ComputeCache(
-    instance, instance.animator->skeleton, skeletalMatrix, false, 0.0f
-  );
+  plugin::animation::ComputeCache(instance, skeletalMatrix, false, 0.0f);
   instance.hasCalculatedCachedInfo = true;
 }
 
@@ -1539,25 +1717,43 @@ void plugin::animation::ConstructInstance(
   }
 
   // set default values for pieces
-  for (auto & piecePair : animationInstance.animator->pieces) {
-    if (piecePair.second.states.begin() == piecePair.second.states.end()) {
+  auto const & animator = *animationInstance.animator;
+  animationInstance.pieceStates.resize(animator.pieceByIdx.size());
+  for (
+    size_t pieceIdx = 0ul; pieceIdx < animator.pieceByIdx.size(); ++ pieceIdx
+  ) {
+    auto & stateInfo = animationInstance.pieceStates[pieceIdx];
+    stateInfo.animator = animationInstance.animator;
+    stateInfo.pieceIdx = pieceIdx;
+
+    auto const & piece = *animator.pieceByIdx[pieceIdx];
+    if (piece.states.begin() == piece.states.end()) {
       spdlog::error(
         "need at least one state for piece '{}' of '{}'"
-      , piecePair.first, animationInstance.animator->label
+      , animator.pieceLabels[pieceIdx], animator.label
       );
       continue;
     }
-    auto & pieceToState = animationInstance.pieceToState[piecePair.first];
-    pieceToState.label = piecePair.second.states.begin()->first;
-    pieceToState.animator = animationInstance.animator;
-    pieceToState.pieceLabel = piecePair.first;
+
+    stateInfo.label = piece.states.begin()->first;
+    stateInfo.stateIdx = 0ul;
   }
 
+  animationInstance.gameplayPieces =
+    pul::animation::Instance::GameplayPieces {
+      .body = animator.PieceIdx("body")
+    , .legs = animator.PieceIdx("legs")
+    , .particle = animator.PieceIdx("particle")
+    , .pickupBg = animator.PieceIdx("pickup-bg")
+    , .pickups = animator.PieceIdx("pickups")
+    , .weaponPlaceholder = animator.PieceIdx("weapon-placeholder")
+    };
+
   { // -- compute initial sokol buffers
 
     // precompute size
     size_t const vertexBufferSize =
-      ::ComputeVertexBufferSize(animationInstance.animator->skeleton);
+      ::ComputeVertexBufferSize(*animationInstance.animator);
 
     animationInstance.uvCoordBufferData.resize(vertexBufferSize);
     animationInstance.originBufferData.resize(vertexBufferSize);
@@ -1621,10 +1817,11 @@ void plugin::animation::DebugUiDispatch(
       PUL_ASSERT(self.instance.animator, continue;);
 
       if (ImGui::TreeNode(self.instance.animator->label.c_str())) {
-        for (auto const & stateInfoPair : self.instance.pieceToState) {
-          auto & stateInfo = stateInfoPair.second;
-
-          pul::imgui::Text("part - '{}'", stateInfoPair.first);
+        auto const & animator = *self.instance.animator;
+        for (auto const & stateInfo : self.instance.pieceStates) {
+          pul::imgui::Text(
+            "part - '{}'", animator.pieceLabels[stateInfo.pieceIdx]
+          );
           pul::imgui::Text("\torigin '{}'", self.instance.origin);
           pul::imgui::Text("\tlabel '{}'", stateInfo.label);
           pul::imgui::Text("\tdelta-time {}", stateInfo.deltaTime);
@@ -1646,11 +1843,13 @@ void plugin::animation::DebugUiDispatch(
           , mat[2][0], mat[2][1], mat[2][2]
           );
 
+          if (stateInfo.stateIdx == -1ul) { continue; }
+
           auto variationType =
-            self.instance.animator
-              ->pieces[stateInfoPair.first]
-              .states[stateInfoPair.second.label]
-              .variationType
+            animator
+              .pieceByIdx[stateInfo.pieceIdx]
+              ->stateByIdx[stateInfo.stateIdx]
+              ->variationType
           ;
 
           pul::imgui::Text("\tvariation type '{}'", ToStr(variationType));
@@ -1679,6 +1878,17 @@ void plugin::animation::DebugUiDispatch(
 
   if (editAnimator) {
 
+    // any part of the animator can be edited, so don't reuse the matrices
+    // cached from it, and keep its compiled uv coords up to date
+    editAnimator->CompileUvCoords();
+
+    for (auto entity : registry.view<pul::animation::ComponentInstance>()) {
+      auto & instance =
+        registry.get<pul::animation::ComponentInstance>(entity).instance;
+      if (instance.animator.get() == editAnimator)
+        { instance.cachedRoot.valid = false; }
+    }
+
     ImGui::Begin("Animation Timeline");
       ImGui::Checkbox("loop", &animLoop);
       ImGui::Checkbox("playing", &animPlaying);
@@ -1751,6 +1961,7 @@ void plugin::animation::DebugUiDispatch(
         ) {
           if (pieceLabel != "") {
             animator.pieces[pieceLabel] = {};
+            ::ReconstructInstances(scene);
           }
           pieceLabel = "";
           ImGui::CloseCurrentPopup();
@@ -1778,6 +1989,7 @@ void plugin::animation::DebugUiDispatch(
             if (ImGui::Button("confirm deletion")) {
               animator.pieces.erase(animator.pieces.find(piecePair.first));
               ::ResetHitboxEdit();
+              ::ReconstructInstances(scene);
               ImGui::EndPopup();
               ImGui::TreePop();
               break;
@@ -1813,6 +2025,7 @@ void plugin::animation::DebugUiDispatch(
                   .variations = {},
                   .msDeltaTime = 100,
                 };
+                ::ReconstructInstances(scene);
               }
               newStateLabel = "";
               ImGui::CloseCurrentPopup();
@@ -1837,6 +2050,7 @@ void plugin::animation::DebugUiDispatch(
               if (ImGui::Button("confirm deletion")) {
                 piece.states.erase(piece.states.find(statePair.first));
                 ::ResetHitboxEdit();
+                ::ReconstructInstances(scene);
                 ImGui::EndPopup();
                 ImGui::TreePop();
                 break;
@@ -3,13 +3,98 @@
 #include <plugin-base/animation/animation.hpp>
 #include <pulcher-animation/animation.hpp>
 #include <pulcher-core/scene-bundle.hpp>
+#include <pulcher-util/parallel.hpp>
+
+#include <algorithm>
+#include <array>
+
+namespace {
+
+size_t animationBufferMaxSize = 4096*4096*5; // ~50MB
+
+// snapshots are evaluated on these instances, which keep their buffers
+// around; one per ParallelFor thread as snapshots are evaluated in parallel
+std::array<pul::animation::Instance, pul::util::maxParallelThreads>
+  scratchInstances;
+
+// snapshot indices of the instances to interpolate; if the previous snapshot
+// was recorded against another compile of the animator, the current one is
+// used on its own
+struct InterpolatePair {
+  size_t previousIdx;
+  size_t currentIdx;
+  bool previousStale;
+};
+
+std::vector<InterpolatePair> interpolatePairs;
+
+} // -- namespace
+
+void plugin::animation::AnimationSnapshot::Clear() {
+  entities.clear();
+  animators.clear();
+  compileGenerations.clear();
+  pieceCounts.clear();
+  origins.clear();
+  hasCalculatedCachedInfo.clear();
+  cachedRoots.clear();
+  pieceOffsets.clear();
+  pieces.clear();
+  pieceAngles.clear();
+}
+
+void plugin::animation::AnimationSnapshot::Record(
+  size_t const entity
+, pul::animation::Instance const & instance
+) {
+  PUL_ASSERT_CMP(
+    instance.pieceStates.size(), ==, instance.animator->pieceByIdx.size()
+  , return;
+  );
 
-static size_t animationBufferMaxSize = 4096*4096*5; // ~50MB
+  entities.emplace_back(entity);
+  animators.emplace_back(instance.animator);
+  compileGenerations.emplace_back(instance.animator->compileGeneration);
+  pieceCounts.emplace_back(instance.pieceStates.size());
+  origins.emplace_back(instance.origin);
+  hasCalculatedCachedInfo.emplace_back(instance.hasCalculatedCachedInfo);
+  cachedRoots.emplace_back(instance.cachedRoot);
+  pieceOffsets.emplace_back(pieces.size());
+
+  for (auto const & state : instance.pieceStates) {
+    pieces.emplace_back(
+      plugin::animation::PieceSnapshot {
+        .cachedLocalSkeletalMatrix = state.cachedLocalSkeletalMatrix
+      , .cachedSkeletalMatrix = state.cachedSkeletalMatrix
+      , .cachedInputs = state.cachedInputs
+      , .variationRti = state.variationRti
+      , .uvCoordWrap = state.uvCoordWrap
+      , .vertWrap = state.vertWrap
+      , .stateIdx = state.stateIdx
+      , .componentIt = state.componentIt
+      , .deltaTime = state.deltaTime
+      , .flip = state.flip
+      , .visible = state.visible
+      , .animationFinished = state.animationFinished
+      , .flipVertWrap = state.flipVertWrap
+      }
+    );
+    pieceAngles.emplace_back(state.angle);
+  }
+}
+
+void plugin::animation::AnimationRenderOutput::Clear() {
+  animators.clear();
+  origins.clear();
+  vertexOffsets.clear();
+  uvCoordBufferData.clear();
+  originBufferData.clear();
+}
 
 void plugin::animation::RenderInterpolated(
   pul::core::SceneBundle const & scene
 , pul::core::RenderBundleInstance const & interpolatedBundle
-, std::vector<plugin::animation::Interpolant> const & interpolants
+, plugin::animation::AnimationRenderOutput const & output
 ) {
   // -- render animations
   auto & animationSystem = scene.AnimationSystem();
@@ -37,23 +122,29 @@ void plugin::animation::RenderInterpolated(
 
   // set capacity and set size to 0
   if (bufferData.capacity() == 0ul)
-    { bufferData.reserve(animationBufferMaxSize / sizeof(glm::vec4)); }
+    { bufferData.reserve(::animationBufferMaxSize / sizeof(glm::vec4)); }
   bufferData.resize(0); // doesn't affect capacity
 
   // record each component to a buffer
-  for (auto & interpolant : interpolants) {
-
-    auto & instance = interpolant.instance;
-
-    for (size_t it = 0; it < instance.originBufferData.size(); ++ it) {
-      auto const origin =
-        instance.originBufferData[it]
-      + glm::vec3(instance.origin, 0.0f)
-      ;
+  for (
+    size_t instanceIt = 0ul; instanceIt < output.animators.size();
+    ++ instanceIt
+  ) {
+    auto const & animator = *output.animators[instanceIt];
+    auto const instanceOrigin = glm::vec3(output.origins[instanceIt], 0.0f);
+
+    size_t const vertexBegin = output.vertexOffsets[instanceIt];
+    size_t const vertexEnd =
+        instanceIt+1ul < output.vertexOffsets.size()
+      ? output.vertexOffsets[instanceIt+1ul] : output.originBufferData.size()
+    ;
+
+    for (size_t it = vertexBegin; it < vertexEnd; ++ it) {
+      auto const origin = output.originBufferData[it] + instanceOrigin;
 
       bufferData.emplace_back(glm::vec4(origin, 0.0f));
       bufferData.emplace_back(
-        glm::vec4(instance.uvCoordBufferData[it], 0.0f, 0.0f)
+        glm::vec4(output.uvCoordBufferData[it], 0.0f, 0.0f)
       );
     }
 
@@ -64,8 +155,8 @@ void plugin::animation::RenderInterpolated(
       );
 
     float textureResolution[2];
-    textureResolution[0] = instance.animator->spritesheet.width;
-    textureResolution[1] = instance.animator->spritesheet.height;
+    textureResolution[0] = animator.spritesheet.width;
+    textureResolution[1] = animator.spritesheet.height;
     sg_apply_uniforms(
       SG_SHADERSTAGE_FS
     , 0
@@ -76,7 +167,7 @@ void plugin::animation::RenderInterpolated(
     auto bindings = animationSystem.sgBindings;
     bindings.vertex_buffer_offsets[0] = offset;
     bindings.vertex_buffer_offsets[1] = offset;
-    bindings.fs_images[0] = instance.animator->spritesheet.Image();
+    bindings.fs_images[0] = animator.spritesheet.Image();
     sg_apply_bindings(bindings);
 
     sg_draw(0, bufferData.size() / 2, 1);
@@ -87,51 +178,167 @@ void plugin::animation::RenderInterpolated(
 
 void plugin::animation::Interpolate(
   const float msDeltaInterp
-, InterpolantMap<plugin::animation::Interpolant> const & interpolantsPrev
-, InterpolantMap<plugin::animation::Interpolant> const & interpolantsCurr
-, std::vector<plugin::animation::Interpolant> & interpolantsOut
+, plugin::animation::AnimationSnapshot const & previous
+, plugin::animation::AnimationSnapshot const & current
+, plugin::animation::AnimationRenderOutput & output
 ) {
-  interpolantsOut.reserve(interpolantsPrev.size());
-
-  for (auto & interpolantPair : interpolantsPrev) {
-
-    auto const interpolantId = std::get<0>(interpolantPair);
-
-    auto const & previous = std::get<1>(interpolantPair).instance;
+  output.Clear();
+  ::interpolatePairs.clear();
+
+  // -- match instances & lay out their output vertices
+
+  // both snapshots are sorted by entity, so instances are matched in a merge
+  size_t vertexCount = 0ul;
+  size_t currentIt = 0ul;
+  for (
+    size_t previousIt = 0ul; previousIt < previous.entities.size();
+    ++ previousIt
+  ) {
+    size_t const entity = previous.entities[previousIt];
+
+    while (
+        currentIt < current.entities.size()
+     && current.entities[currentIt] < entity
+    ) {
+      ++ currentIt;
+    }
 
     // locate current, if it doesn't exist then this object has been destroyed
-    auto currentPtr = interpolantsCurr.find(interpolantId);
-    if (currentPtr == interpolantsCurr.end()) { continue; }
-
-    auto & current  = std::get<1>(*currentPtr).instance;
-
-    // TODO
-    /* if (instance.automaticCachedMatrixCalculation) */
-    /*   { instance.hasCalculatedCachedInfo = false; } */
+    if (
+        currentIt == current.entities.size()
+     || current.entities[currentIt] != entity
+    ) {
+      continue;
+    }
 
-    // copy instance
-    auto interpolant = plugin::animation::Interpolant { previous };
-    auto & instance = interpolant.instance;
+    auto const * const animator = current.animators[currentIt].get();
+
+    // the pieces are evaluated on the animator as it is now, so a snapshot
+    // recorded against another compile of it, such as before the editor
+    // recompiled it, can't be used
+    auto const matchesAnimator =
+      [animator](
+        plugin::animation::AnimationSnapshot const & snapshot, size_t const idx
+      ) {
+        return
+            snapshot.animators[idx].get() == animator
+         && snapshot.compileGenerations[idx] == animator->compileGeneration
+         && snapshot.pieceCounts[idx] == animator->pieceByIdx.size()
+        ;
+      };
+
+    if (!matchesAnimator(current, currentIt)) { continue; }
+
+    ::interpolatePairs.emplace_back(
+      ::InterpolatePair {
+        .previousIdx = previousIt
+      , .currentIdx = currentIt
+      , .previousStale = !matchesAnimator(previous, previousIt)
+      }
+    );
 
-    // create an interpolated instance to compute vertices from
-    instance.origin = glm::mix(previous.origin, current.origin, msDeltaInterp);
+    output.animators.emplace_back(animator);
+    output.origins.emplace_back(
+      glm::mix(
+        previous.origins[previousIt], current.origins[currentIt]
+      , msDeltaInterp
+      )
+    );
+    output.vertexOffsets.emplace_back(vertexCount);
 
-    for (auto & piecePair : instance.pieceToState) {
-      auto const & label = std::get<0>(piecePair);
-      auto & state = std::get<1>(piecePair);
-      auto const & statePrev = previous.pieceToState.at(label);
-      auto const & stateCurr = current.pieceToState.at(label);
+    vertexCount += animator->flatSkeleton.size() * 6ul;
+  }
 
-      state.angle = glm::mix(statePrev.angle, stateCurr.angle, msDeltaInterp);
+  output.uvCoordBufferData.resize(vertexCount);
+  output.originBufferData.resize(vertexCount);
+
+  // -- compute vertices; each instance writes only to its own vertices
+  auto const interpolateRange = [&](size_t const begin, size_t const end) {
+    auto & instance = ::scratchInstances[pul::util::ParallelWorkerIdx()];
+
+    for (size_t pairIt = begin; pairIt < end; ++ pairIt) {
+      auto const & pair = ::interpolatePairs[pairIt];
+      size_t const currentIdx = pair.currentIdx;
+
+      // a stale previous snapshot is replaced by the current one, which
+      // evaluates the current state without interpolating it
+      auto const & source = pair.previousStale ? current : previous;
+      size_t const sourceIdx =
+        pair.previousStale ? pair.currentIdx : pair.previousIdx;
+
+      auto const & animator = current.animators[currentIdx];
+      instance.animator = animator;
+
+      // create an interpolated instance to compute vertices from
+      instance.origin = output.origins[pairIt];
+
+      instance.hasCalculatedCachedInfo =
+        source.hasCalculatedCachedInfo[sourceIdx];
+
+      // matrices that were cached during the logic frame are reused
+      instance.cachedRoot = source.cachedRoots[sourceIdx];
+
+      size_t const pieceCount = current.pieceCounts[currentIdx];
+      size_t const sourceOffset  = source.pieceOffsets[sourceIdx];
+      size_t const currentOffset = current.pieceOffsets[currentIdx];
+
+      instance.pieceStates.resize(pieceCount);
+      for (size_t pieceIdx = 0ul; pieceIdx < pieceCount; ++ pieceIdx) {
+        auto & state = instance.pieceStates[pieceIdx];
+        auto const & piecePrev = source.pieces[sourceOffset + pieceIdx];
+        float const anglePrev = source.pieceAngles[sourceOffset + pieceIdx];
+        float const angleCurr = current.pieceAngles[currentOffset + pieceIdx];
+
+        state.pieceIdx                  = pieceIdx;
+        state.stateIdx                  = piecePrev.stateIdx;
+        state.componentIt               = piecePrev.componentIt;
+        state.deltaTime                 = piecePrev.deltaTime;
+        state.flip                      = piecePrev.flip;
+        state.visible                   = piecePrev.visible;
+        state.animationFinished         = piecePrev.animationFinished;
+        state.uvCoordWrap               = piecePrev.uvCoordWrap;
+        state.vertWrap                  = piecePrev.vertWrap;
+        state.flipVertWrap              = piecePrev.flipVertWrap;
+        state.variationRti              = piecePrev.variationRti;
+        state.cachedLocalSkeletalMatrix = piecePrev.cachedLocalSkeletalMatrix;
+        state.cachedSkeletalMatrix      = piecePrev.cachedSkeletalMatrix;
+        state.cachedInputs              = piecePrev.cachedInputs;
+
+        // mixing equal angles might not be exact, which would dirty the cache
+        state.angle =
+            anglePrev == angleCurr
+          ? anglePrev
+          : glm::mix(anglePrev, angleCurr, msDeltaInterp)
+        ;
+      }
+
+      size_t const instanceVertexCount = animator->flatSkeleton.size() * 6ul;
+      instance.uvCoordBufferData.resize(instanceVertexCount);
+      instance.originBufferData.resize(instanceVertexCount);
+
+      // compute vertices
+      plugin::animation::ComputeCache(instance, glm::mat3(1.0f), false, 0.0f);
+
+      plugin::animation::ComputeVertices(instance, true);
+
+      size_t const vertexOffset = output.vertexOffsets[pairIt];
+      std::copy(
+        instance.uvCoordBufferData.begin(), instance.uvCoordBufferData.end()
+      , output.uvCoordBufferData.begin() + vertexOffset
+      );
+      std::copy(
+        instance.originBufferData.begin(), instance.originBufferData.end()
+      , output.originBufferData.begin() + vertexOffset
+      );
     }
 
-    // compute vertices
-    plugin::animation::ComputeCache(
-      instance, instance.animator->skeleton, glm::mat3(1.0f), false, 0.0f
-    );
+    instance.animator = {};
+  };
 
-    plugin::animation::ComputeVertices(instance, true);
+  pul::util::ParallelFor(::interpolatePairs.size(), 16ul, interpolateRange);
+}
 
-    interpolantsOut.emplace_back(std::move(interpolant));
-  }
+void plugin::animation::ReleaseInterpolationScratch() {
+  ::scratchInstances = {};
+  ::interpolatePairs = {};
 }
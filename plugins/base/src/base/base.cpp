@@ -19,6 +19,7 @@ extern "C" {
 PUL_PLUGIN_DECL void Plugin_LogicUpdate(
   pul::core::SceneBundle & scene
 ) {
+  plugin::physics::UpdateEntityBroadphase(scene);
   plugin::entity::Update(scene);
   plugin::animation::UpdateFrame(scene);
   plugin::physics::SimulatePhysics();
@@ -47,6 +48,7 @@ PUL_PLUGIN_DECL void Plugin_Shutdown(pul::core::SceneBundle & scene) {
   scene.AudioSystem().Shutdown();
   plugin::map::Shutdown();
   plugin::physics::ClearMapGeometry();
+  plugin::physics::Shutdown();
   plugin::entity::Shutdown(scene);
   plugin::bot::Shutdown();
   plugin::debug::ShapesRenderShutdown();
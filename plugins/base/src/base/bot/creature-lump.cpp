@@ -34,7 +34,8 @@ void plugin::bot::UpdateCreatureLump(
   auto & damageable = registry.get<pul::core::ComponentDamageable>(selfEntity);
   auto & origin = registry.get<pul::util::ComponentOrigin>(selfEntity).origin;
 
-  auto & animationState = animation.instance.pieceToState["body"];
+  auto & animationState =
+    animation.instance.PieceState(animation.instance.gameplayPieces.body);
 
   for (auto & damage : damageable.frameDamageInfos) {
     self.state =
@@ -53,7 +54,9 @@ void plugin::bot::UpdateCreatureLump(
       , glm::round(origin + glm::vec2(0.0f, +10.0f))
     );
     pul::physics::IntersectionResults floorResults;
-    plugin::physics::IntersectionRaycast(scene, floorRay, floorResults);
+    plugin::physics::IntersectionRaycast(
+      plugin::physics::World(), floorRay, floorResults
+    );
 
     self.checkForGrounded = !floorResults.collision;
 
@@ -137,7 +140,9 @@ void plugin::bot::UpdateCreatureLump(
         );
 
       pul::physics::IntersectionResults wallResults;
-      plugin::physics::IntersectionRaycast(scene, wallRay, wallResults);
+      plugin::physics::IntersectionRaycast(
+        plugin::physics::World(), wallRay, wallResults
+      );
 
       if (wallResults.collision) {
         self.movementStateActive = true;
@@ -229,7 +234,9 @@ void plugin::bot::UpdateCreatureLump(
         , glm::round(origin + dodge.airVelocity)
       );
       pul::physics::IntersectionResults floorResults;
-      plugin::physics::IntersectionRaycast(scene, floorRay, floorResults);
+      plugin::physics::IntersectionRaycast(
+        plugin::physics::World(), floorRay, floorResults
+      );
 
       if (dodge.airVelocity.y > 0.0f && floorResults.collision) {
         origin = floorResults.origin;
@@ -298,7 +305,9 @@ void plugin::bot::UpdateCreatureLump(
         , glm::round(origin + flip.airVelocity)
       );
       pul::physics::IntersectionResults floorResults;
-      plugin::physics::IntersectionRaycast(scene, floorRay, floorResults);
+      plugin::physics::IntersectionRaycast(
+        plugin::physics::World(), floorRay, floorResults
+      );
 
       if (flip.airVelocity.y > 0.0f && floorResults.collision) {
         origin = floorResults.origin;
@@ -35,7 +35,8 @@ void plugin::bot::UpdateCreatureMoldWing(
   auto & damageable = registry.get<pul::core::ComponentDamageable>(selfEntity);
   auto & origin = registry.get<pul::util::ComponentOrigin>(selfEntity).origin;
 
-  auto & animationState = animation.instance.pieceToState["body"];
+  auto & animationState =
+    animation.instance.PieceState(animation.instance.gameplayPieces.body);
 
   for (auto & damage : damageable.frameDamageInfos) {
     damageable.health = glm::max(damageable.health - damage.damage, 0);
@@ -100,7 +100,8 @@ void plugin::bot::UpdateCreatureVapivara(
   auto & damageable = registry.get<pul::core::ComponentDamageable>(selfEntity);
   auto & origin = registry.get<pul::util::ComponentOrigin>(selfEntity).origin;
 
-  auto & animationState = animation.instance.pieceToState["body"];
+  auto & animationState =
+    animation.instance.PieceState(animation.instance.gameplayPieces.body);
 
   for (auto & damage : damageable.frameDamageInfos) {
     damageable.health = glm::max(damageable.health - damage.damage, 0);
@@ -115,7 +116,9 @@ void plugin::bot::UpdateCreatureVapivara(
       , glm::round(origin + glm::vec2(0.0f, +10.0f))
     );
     pul::physics::IntersectionResults floorResults;
-    plugin::physics::IntersectionRaycast(scene, floorRay, floorResults);
+    plugin::physics::IntersectionRaycast(
+      plugin::physics::World(), floorRay, floorResults
+    );
 
     if (!floorResults.collision) {
       origin.y += 10.0f;
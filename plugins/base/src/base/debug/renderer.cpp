@@ -5,9 +5,14 @@
 #include <pulcher-gfx/sokol.hpp>
 #include <pulcher-gfx/image.hpp>
 #include <pulcher-gfx/imgui.hpp>
+#include <pulcher-util/parallel.hpp>
 
 #include <glad/glad.hpp>
 
+#include <algorithm>
+#include <array>
+#include <vector>
+
 namespace {
   // sokol information related to debug rendering
   struct DebugRenderInfo {
@@ -40,6 +45,35 @@ namespace {
   // as that length will be cleared out after a swap, however we will still be
   // required to render for interpolated frames
   size_t debugRenderLineDrawCalls = 0;
+
+  // lines are recorded per ParallelFor thread, so shapes can be emitted from
+  // updates that run in parallel. They are merged into the upload buffer
+  // before rendering, at which point no update may be recording
+  struct ThreadLineBuffer {
+    std::vector<glm::vec4> lines; // <origin, color> pairs, 4 per line
+  };
+
+  std::array<ThreadLineBuffer, pul::util::maxParallelThreads> threadLineBuffers;
+
+  ThreadLineBuffer & LocalLineBuffer() {
+    return ::threadLineBuffers[pul::util::ParallelWorkerIdx()];
+  }
+
+  void MergeThreadLineBuffers() {
+    for (auto & buffer : ::threadLineBuffers) {
+      for (size_t it = 0ul; it < buffer.lines.size(); it += 4ul) {
+        if (::debugRenderLineLength >= ::maxPrimitives) { break; }
+
+        auto offset = ::debugRenderLineBegin + ::debugRenderLineLength*4;
+        std::copy_n(
+          buffer.lines.begin() + it, 4ul, ::debugUploadBuffer.begin() + offset
+        );
+
+        ++ ::debugRenderLineLength;
+      }
+      buffer.lines.clear();
+    }
+  }
 }
 
 void plugin::debug::ShapesRenderInitialize() {
@@ -150,6 +184,7 @@ void plugin::debug::ShapesRenderShutdown() {
   sg_destroy_shader(::debugRenderCircle.program);
 
   ::debugBuffer.Destroy();
+  ::threadLineBuffers = {};
 
   debugRenderLineLength = -1ul;
 }
@@ -158,16 +193,14 @@ void plugin::debug::RenderLine(
   glm::vec2 start, glm::vec2 end, glm::vec3 color
 ) {
 
-  if (::debugRenderLineLength >= ::maxPrimitives) { return; }
-
-  auto offset = ::debugRenderLineBegin + ::debugRenderLineLength*4;
+  auto & lines = ::LocalLineBuffer().lines;
 
-  ::debugUploadBuffer[offset + 0] = glm::vec4(start, 0.0f, 1.0f);
-  ::debugUploadBuffer[offset + 1] = glm::vec4(color, 1.0f);
-  ::debugUploadBuffer[offset + 2] = glm::vec4(end, 0.0f, 1.0f);
-  ::debugUploadBuffer[offset + 3] = glm::vec4(color, 1.0f);
+  if (lines.size() >= ::maxPrimitives*4) { return; }
 
-  ++ ::debugRenderLineLength;
+  lines.emplace_back(start, 0.0f, 1.0f);
+  lines.emplace_back(color, 1.0f);
+  lines.emplace_back(end, 0.0f, 1.0f);
+  lines.emplace_back(color, 1.0f);
 }
 
 void plugin::debug::RenderAabbByCenter(
@@ -236,6 +269,8 @@ void plugin::debug::ShapesRender(
 , pul::core::RenderBundleInstance const &
 ) {
 
+  ::MergeThreadLineBuffers();
+
   // check if buffer needs to be updated
   if (::debugRenderLineLength != 0ul) {
     plugin::debug::ShapesRenderSwap();
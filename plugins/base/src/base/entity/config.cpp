@@ -251,6 +251,11 @@ namespace plugin::config {
       return projectileVelocity;
     }
 
+    int32_t & ProjectileCollisionRadius() {
+      static int32_t projectileCollisionRadius = 4;
+      return projectileCollisionRadius;
+    }
+
     int32_t & ProjectileExplosionRadius() {
       static int32_t projectileExplosionRadius = 96;
       return projectileExplosionRadius;
@@ -743,6 +748,7 @@ void ApplyToConfig(
     namespace config = plugin::config::pericaliya::primary;
     fnInt(config::DischargeCooldown(), "pericaliya::primary::dischargeCooldown");
     fnFloat(config::ProjectileVelocity(), "pericaliya::primary::projectileVelocity");
+    fnInt(config::ProjectileCollisionRadius(), "pericaliya::primary::projectileCollisionRadius");
     fnInt(config::ProjectileExplosionRadius(), "pericaliya::primary::projectileExplosionRadius");
     fnFloat(config::ProjectileExplosionForce(), "pericaliya::primary::projectileExplosionForce");
     fnInt(config::ProjectileSplashDamageMin(), "pericaliya::primary::projectileSplashDamageMin");
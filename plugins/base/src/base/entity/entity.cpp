@@ -35,6 +35,9 @@
 #include <glm/gtx/transform2.hpp>
 #include <imgui/imgui.hpp>
 
+#include <array>
+#include <span>
+
 namespace {
 
 bool botPlays = false;
@@ -105,44 +108,72 @@ void plugin::entity::Update(pul::core::SceneBundle & scene) {
 
       bool explode =
           exploder.explodeOnDelete
-       && animation.instance.pieceToState["particle"].animationFinished
+       && animation
+            .instance
+            .PieceState(animation.instance.gameplayPieces.particle)
+            .animationFinished
       ;
 
       entt::entity playerDirectHit = entt::null;
 
       glm::vec2 explodeOrigin = particle.origin;
 
-      // check if physics bound
+      // tiles & players in a single sweep, whichever is hit first. Entities
+      // that can't take damage are passed through by sweeping again without
+      // them; past a few of those only the tiles are considered
       if (!explode) {
-        auto ray =
-          pul::physics::IntersectorRay::Construct(
-            animation.instance.origin,
-            animation.instance.origin + particle.velocity
-          );
+        std::array<entt::entity, 4ul> passedEntities;
+        size_t passedEntityCount = 0ul;
+
+        pul::physics::IntersectorSweptCircle sweep;
+        sweep.origin = animation.instance.origin;
+        sweep.velocity = particle.velocity;
+        sweep.radius = exploder.collisionRadius;
+        sweep.ignoredEntity = exploder.damage.ignoredPlayer;
+        sweep.testLayer = exploder.explodeOnCollide;
+
+        glm::vec2 const direction =
+          particle.velocity == glm::vec2(0.0f)
+        ? glm::vec2(0.0f) : glm::normalize(particle.velocity);
+
+        for (;;) {
+          sweep.ignoredEntities =
+            std::span(passedEntities.data(), passedEntityCount);
+          sweep.testEntities =
+              exploder.damage.damagePlayer
+           && passedEntityCount < passedEntities.size()
+          ;
 
-        if (
-          pul::physics::IntersectionResults results;
-          plugin::physics::IntersectionRaycast(scene, ray, results)
-        ) {
-          explodeOrigin = results.origin;
-          explode |= exploder.explodeOnCollide;
-        }
-      }
+          pul::physics::SweptCircleIntersectionResults results;
+          if (
+            !plugin::physics::IntersectionSweptCircle(
+              plugin::physics::World(), scene, sweep, results
+            )
+          ) {
+            break;
+          }
 
-      // check for player
-      if (!explode && exploder.damage.damagePlayer) {
-        playerDirectHit =
-          plugin::entity::WeaponDamageRaycast(
-            scene
-          , animation.instance.origin
-          , animation.instance.origin + particle.velocity
-          , exploder.damage.playerDirectDamage
-          , exploder.damage.explosionForce
-          , exploder.damage.ignoredPlayer
-          ).entity
-        ;
+          if (results.entity == entt::null) {
+            explodeOrigin = results.origin;
+            explode = true;
+            break;
+          }
 
-        explode |= playerDirectHit != entt::null;
+          if (
+            plugin::entity::WeaponDamageEntity(
+              scene, results.entity, direction
+            , exploder.damage.playerDirectDamage
+            , exploder.damage.explosionForce
+            )
+          ) {
+            explodeOrigin = results.origin;
+            playerDirectHit = results.entity;
+            explode = true;
+            break;
+          }
+
+          passedEntities[passedEntityCount++] = results.entity;
+        }
       }
 
       if (explode) {
@@ -161,11 +192,6 @@ void plugin::entity::Update(pul::core::SceneBundle & scene) {
             exploder.damage.damagePlayer
          && exploder.damage.explosionRadius > 0.0f
         ) {
-          pul::physics::IntersectorCircle circle;
-          circle.origin = explodeOrigin;
-          circle.radius = exploder.damage.explosionRadius;
-          pul::physics::EntityIntersectionResults results;
-
           plugin::entity::WeaponDamageCircle(
             scene
           , explodeOrigin
@@ -194,9 +220,13 @@ void plugin::entity::Update(pul::core::SceneBundle & scene) {
       auto & animation = view.get<pul::animation::ComponentInstance>(entity);
       auto & particle = view.get<pul::core::ComponentParticleGrenade>(entity);
 
-      bool destroyInstance =
-        animation.instance.pieceToState["particle"].animationFinished
-      ;
+      // the piece states outlive moves of the instance
+      auto & particleState =
+        animation.instance.PieceState(
+          animation.instance.gameplayPieces.particle
+        );
+
+      bool destroyInstance = particleState.animationFinished;
 
       // negate before comparison so that physics are ran on frame of
       // destruction
@@ -219,35 +249,21 @@ void plugin::entity::Update(pul::core::SceneBundle & scene) {
 
         if (
           pul::physics::IntersectionResults results;
-          plugin::physics::IntersectionRaycast(scene, ray, results)
+          plugin::physics::IntersectionRaycast(
+            plugin::physics::World(), ray, results
+          )
         ) {
-          // calculate normal (TODO this should be precomputed)
-          glm::vec2 normal = glm::vec2(0.0f);
-
-          for (auto point : std::vector<glm::vec2>{
-            { -1.0f, -1.0f }, { +0.0f, -1.0f }, { +1.0f, -1.0f }
-          , { -1.0f, +0.0f },                   { +1.0f, +0.0f }
-          , { -1.0f, +1.0f }, { +0.0f, +1.0f }, { +1.0f, +1.0f }
-          }) {
-            auto pointInt =
-              pul::physics::IntersectorPoint{
-                glm::i32vec2(glm::vec2(results.origin) + point)
-              };
-            if (
-              pul::physics::IntersectionResults pointResult;
-              plugin::physics::IntersectionPoint(scene, pointInt, pointResult)
-            ) {
-              normal += point;
-            }
-          }
-          normal = glm::normalize(normal);
+          // bounce straight back if the surface normal is degenerate
+          glm::vec2 const normal =
+            results.normal != glm::vec2(0.0f)
+          ? results.normal : -glm::normalize(particle.velocity)
+          ;
 
-          // TODO have to detect normal of wall...
           animation.instance.origin = results.origin;
           particle.origin = results.origin;
           // reflect velocity
           glm::vec2 const targetDirection =
-            glm::reflect(glm::normalize(particle.velocity), -normal);
+            glm::reflect(glm::normalize(particle.velocity), normal);
           particle.velocity =
               glm::length(particle.velocity)
             * targetDirection
@@ -270,12 +286,12 @@ void plugin::entity::Update(pul::core::SceneBundle & scene) {
             , particle.bounceAnimation.c_str()
             );
 
-            bounceAnimation
-              .pieceToState["particle"]
-              .Apply(particle.bounceAnimation, true);
-
-            bounceAnimation.pieceToState["particle"].angle
-              = animation.instance.pieceToState["particle"].angle;
+            auto & bounceState =
+              bounceAnimation.PieceState(
+                bounceAnimation.gameplayPieces.particle
+              );
+            bounceState.Apply(particle.bounceAnimation, true);
+            bounceState.angle = particleState.angle;
 
             bounceAnimation.origin = animation.instance.origin;
 
@@ -316,7 +332,7 @@ void plugin::entity::Update(pul::core::SceneBundle & scene) {
       particle.origin += particle.velocity;
       animation.instance.origin += particle.velocity;
 
-      animation.instance.pieceToState["particle"].angle =
+      particleState.angle =
         std::atan2(particle.velocity.x, particle.velocity.y);
 
       if (destroyInstance) {
@@ -336,11 +352,6 @@ void plugin::entity::Update(pul::core::SceneBundle & scene) {
             particle.damage.damagePlayer
          && particle.damage.explosionRadius > 0.0f
         ) {
-          pul::physics::IntersectorCircle circle;
-          circle.origin = animation.instance.origin;
-          circle.radius = particle.damage.explosionRadius;
-          pul::physics::EntityIntersectionResults results;
-
           plugin::entity::WeaponDamageCircle(
             scene
           , animation.instance.origin
@@ -367,6 +378,10 @@ void plugin::entity::Update(pul::core::SceneBundle & scene) {
     for (auto entity : view) {
       auto & animation = view.get<pul::animation::ComponentInstance>(entity);
       auto & particle = view.get<pul::core::ComponentParticle>(entity);
+      auto & particleState =
+        animation.instance.PieceState(
+          animation.instance.gameplayPieces.particle
+        );
 
       if (particle.velocity != glm::vec2()) {
         if (particle.gravityAffected) {
@@ -382,11 +397,11 @@ void plugin::entity::Update(pul::core::SceneBundle & scene) {
         particle.origin += particle.velocity;
         animation.instance.origin += particle.velocity;
 
-        animation.instance.pieceToState["particle"].angle =
+        particleState.angle =
           std::atan2(particle.velocity.x, particle.velocity.y);
       }
 
-      if (animation.instance.pieceToState["particle"].animationFinished) {
+      if (particleState.animationFinished) {
         animation.instance = {};
         registry.destroy(entity);
       }
@@ -418,12 +433,11 @@ void plugin::entity::Update(pul::core::SceneBundle & scene) {
         }
       }
 
-      animation.instance.pieceToState["pickups"].visible = pickup.spawned;
-      if (
-          animation.instance.pieceToState.find("pickup-bg")
-       != animation.instance.pieceToState.end()
-      ) {
-        animation.instance.pieceToState["pickup-bg"].visible = pickup.spawned;
+      auto const & pieces = animation.instance.gameplayPieces;
+      animation.instance.PieceState(pieces.pickups).visible = pickup.spawned;
+      if (pieces.pickupBg != -1ul) {
+        animation.instance.PieceState(pieces.pickupBg).visible =
+          pickup.spawned;
       }
 
       animation.instance.origin = pickup.origin;
@@ -555,7 +569,7 @@ void plugin::entity::Update(pul::core::SceneBundle & scene) {
 
       auto const & playerAnim = *projectile.playerAnimation;
       auto const & weaponState =
-        playerAnim.pieceToState.at("weapon-placeholder");
+        playerAnim.PieceState(playerAnim.gameplayPieces.weaponPlaceholder);
       auto const & weaponMatrix = weaponState.cachedLocalSkeletalMatrix;
 
       plugin::animation::UpdateCacheWithPrecalculatedMatrix(
@@ -654,12 +668,18 @@ void plugin::entity::Update(pul::core::SceneBundle & scene) {
         , emitter.animationInstance.animator->label.c_str()
         );
 
-        animationInstance
-          .pieceToState["particle"]
-          .Apply(emitter.animationInstance.animator->label.c_str(), true);
-
-        animationInstance.pieceToState["particle"].angle
-          = animation.instance.pieceToState["particle"].angle;
+        auto & particleState =
+          animationInstance.PieceState(
+            animationInstance.gameplayPieces.particle
+          );
+        particleState.Apply(
+          emitter.animationInstance.animator->label.c_str(), true
+        );
+        particleState.angle =
+          animation
+            .instance
+            .PieceState(animation.instance.gameplayPieces.particle)
+            .angle;
 
         animationInstance.origin = animation.instance.origin;
 
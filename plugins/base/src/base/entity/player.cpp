@@ -307,7 +307,10 @@ void PlayerCheckPickups(
 
     auto const pickupOrigin =
       glm::vec2(
-        animation.instance.pieceToState["pickups"].cachedLocalSkeletalMatrix
+        animation
+          .instance
+          .PieceState(animation.instance.gameplayPieces.pickups)
+          .cachedLocalSkeletalMatrix
       * glm::vec3(pickup.origin, 1.0f)
       )
     ;
@@ -393,175 +396,89 @@ void UpdatePlayerPhysics(
   auto const & pointUl = ::pickPoints[Idx(::PickPointType::Ul)];
   auto const & pointLr = ::pickPoints[Idx(::PickPointType::Lr)];
 
-  // left/right/top/bottom layer
-  struct IterLayerInfo {
-    bool horizontal; // vertical or horizontal
-    bool alternative; // lines are alternative (ei top or bottom)
-  };
-
-
-  glm::vec2 closestIntersectionPlayerOriginOffset;
-  float closestIntersectionDistance = 99999.0f;
-  glm::vec2 closestPushDirection = {};
-  pul::physics::IntersectionResults closestIntersectionPointResults;
-
-  closestIntersectionPointResults.collision = false;
-
-  // left, right, top, bottom
-  for (auto const layer :
-    {
-      IterLayerInfo { false, false }, IterLayerInfo { false, true }
-    , IterLayerInfo { true,  false }, IterLayerInfo { true,  true }
-    }
+  // sweep the pick point rectangle along the velocity, pixels of the border
+  // are inclusive so the box spans up to the far edge of pointLr
+  glm::vec2 const sweepOffset =
+    glm::vec2(pointUl + pointLr + glm::i32vec2(1)) * 0.5f;
+
+  pul::physics::IntersectorSweptAabb sweep;
+  sweep.dimensions = glm::vec2(pointLr - pointUl + glm::i32vec2(1));
+
+  // on contact, slide along the surface for the rest of the motion. Contact
+  // normals are axis aligned, so each contact removes an axis of the motion
+  // and the box comes to rest after a couple of slides
+  size_t constexpr maxSlides = 3ul;
+  glm::vec2 motion = player.velocity;
+  for (
+    size_t slide = 0ul; slide < maxSlides && motion != glm::vec2(0.0f);
+    ++ slide
   ) {
+    sweep.origin = playerOrigin + sweepOffset;
+    sweep.velocity = motion;
 
-    int32_t pixXStart = 0, pixXEnd = 0, pixYStart = 0, pixYEnd = 0;
-
-    glm::vec2 pushDirection = {};
-
-    // select start/end point
-    if (layer.horizontal && layer.alternative) { // bottom
-      pixXStart = pointUl.x; pixXEnd = pointLr.x;
-      pixYStart = pointLr.y; pixYEnd = pointLr.y;
-      pushDirection = glm::vec2(0.0f, -1.0f);
-    } else if (layer.horizontal && !layer.alternative) { // top
-      pixXStart = pointUl.x; pixXEnd = pointLr.x;
-      pixYStart = pointUl.y; pixYEnd = pointUl.y;
-      pushDirection = glm::vec2(0.0f, +1.0f);
-    } else if (!layer.horizontal && layer.alternative) { // right
-      pixXStart = pointLr.x; pixXEnd = pointLr.x;
-      pixYStart = pointUl.y; pixYEnd = pointLr.y;
-      pushDirection = glm::vec2(-1.0f, 0.0f);
-    } else if (!layer.horizontal && !layer.alternative) { // left
-      pixXStart = pointUl.x; pixXEnd = pointUl.x;
-      pixYStart = pointUl.y; pixYEnd = pointLr.y;
-      pushDirection = glm::vec2(+1.0f, 0.0f);
+    pul::physics::SweptIntersectionResults sweepResults;
+    if (
+      !plugin::physics::IntersectionSweptAabb(
+        plugin::physics::World(), sweep, sweepResults
+      )
+    ) {
+      playerOrigin += motion;
+      break;
     }
 
-    // iteratee linearly (only one axis would be iterated through)
-    glm::i32vec2 pixIt = glm::i32vec2(pixXStart, pixYStart);
-
-    // apply initial iteration
-    if (layer.horizontal) { ++ pixIt.x; }
-    else                  { ++ pixIt.y; }
-
-    while (layer.horizontal ? (pixIt.x < pixXEnd) : (pixIt.y < pixYEnd)) {
-
-      glm::vec2 const origin = glm::round(glm::vec2(pixIt) + playerOrigin);
-
-      // apply intersection
-      auto pointRay =
-        pul::physics::IntersectorRay::Construct(
-          glm::round(origin + glm::sign(player.velocity))
-        , glm::round(origin + glm::vec2(player.velocity))
-        );
-      pul::physics::IntersectionResults pointResults;
-      plugin::physics::IntersectionRaycast(scene, pointRay, pointResults);
-
-      // update closest info
-      auto distToPlayer = glm::length(origin - glm::vec2(pointResults.origin));
-      if (
-            pointResults.collision
-         && distToPlayer >= 0.0f && distToPlayer < closestIntersectionDistance
-      ) {
-        closestIntersectionDistance = distToPlayer;
-        closestIntersectionPlayerOriginOffset = glm::vec2(pixIt);
-        closestPushDirection = pushDirection;
-        closestIntersectionPointResults = pointResults;
-
-        // attempt to compute normal
-      }
-
-      // apply iteration
-      if (layer.horizontal) { ++ pixIt.x; }
-      else                  { ++ pixIt.y; }
-    }
+    // move up to the contact and drop the motion & velocity into the surface
+    glm::vec2 const tangent = glm::vec2(1.0f) - glm::abs(sweepResults.normal);
+    playerOrigin += motion * sweepResults.timeOfImpact;
+    motion *= (1.0f - sweepResults.timeOfImpact) * tangent;
+    player.velocity *= tangent;
   }
 
-  if (closestIntersectionPointResults.collision) {
-    spdlog::info(
-      "offset {} push directoin {}",
-      (closestIntersectionPlayerOriginOffset)
-    , closestPushDirection
+  // -- ground & wall cling rays, from the resolved origin
+  std::array<pul::physics::IntersectorRay, 3> borderRays;
+  std::array<pul::physics::IntersectionResults, 3> borderResults;
+
+  // ground check
+  borderRays[0] =
+    pul::physics::IntersectorRay::Construct(
+      glm::round(
+        glm::vec2(::pickPoints[2] + glm::i32vec2(-1, 1.0f)) + playerOrigin
+      )
+    , glm::round(
+        glm::vec2(::pickPoints[3] + glm::i32vec2(+1, 1.0f)) + playerOrigin
+      )
     );
 
-    playerOrigin =
-      glm::vec2(closestIntersectionPointResults.origin)
-    - closestIntersectionPlayerOriginOffset
-    + closestPushDirection
-    ;
-    player.velocity =
-      player.velocity * (glm::vec2(1.0f) - glm::abs(closestPushDirection))
-    ;
-  } else {
-    playerOrigin += player.velocity;
-  }
+  // wall cling right
+  borderRays[1] =
+    pul::physics::IntersectorRay::Construct(
+      glm::round(glm::vec2(pickPoints[1] + glm::i32vec2(+1, +8)) + playerOrigin)
+    , glm::round(glm::vec2(pickPoints[2] + glm::i32vec2(+1, -8)) + playerOrigin)
+    );
 
-  player.prevGrounded = player.grounded;
-  player.grounded = false;
+  // wall cling left
+  borderRays[2] =
+    pul::physics::IntersectorRay::Construct(
+      glm::round(glm::vec2(pickPoints[0] + glm::i32vec2(-1, +8)) + playerOrigin)
+    , glm::round(glm::vec2(pickPoints[3] + glm::i32vec2(-1, -8)) + playerOrigin)
+    );
 
-  { // ground check
-    glm::i32vec2 const
-      point0 = ::pickPoints[2] + glm::i32vec2(-1, 1.0f)
-    , point1 = ::pickPoints[3] + glm::i32vec2(+1, 1.0f)
-    ;
-    auto borderRay =
-      pul::physics::IntersectorRay::Construct(
-        glm::round(glm::vec2(point0) + playerOrigin)
-      , glm::round(glm::vec2(point1) + playerOrigin)
-      );
+  plugin::physics::IntersectionRaycastBatch(
+    plugin::physics::World(), borderRays, borderResults
+  );
 
-    pul::physics::IntersectionResults borderResults;
-    plugin::physics::IntersectionRaycast(scene, borderRay, borderResults);
+  player.prevGrounded = player.grounded;
+  player.grounded = false;
 
-    if (borderResults.collision) {
-      player.grounded = true;
-      player.velocity.y = 0.0f;
-    }
+  if (borderResults[0].collision) {
+    player.grounded = true;
+    player.velocity.y = 0.0f;
   }
 
   // -- wall clinging
   player.prevWallClingLeft  = player.wallClingLeft;
   player.prevWallClingRight = player.wallClingRight;
-  player.wallClingLeft = player.wallClingRight = false;
-
-  { // wall cling right
-    glm::i32vec2 const
-      point0 = pickPoints[1] + glm::i32vec2(+1, +8)
-    , point1 = pickPoints[2] + glm::i32vec2(+1, -8)
-    ;
-    auto borderRay =
-      pul::physics::IntersectorRay::Construct(
-        glm::round(glm::vec2(point0) + playerOrigin)
-      , glm::round(glm::vec2(point1) + playerOrigin)
-      );
-
-    pul::physics::IntersectionResults borderResults;
-    plugin::physics::IntersectionRaycast(scene, borderRay, borderResults);
-
-    if (borderResults.collision) {
-      player.wallClingRight = true;
-    }
-  }
-
-  { // wall cling left
-    glm::vec2 const
-      point0 = pickPoints[0] + glm::i32vec2(-1, +8)
-    , point1 = pickPoints[3] + glm::i32vec2(-1, -8)
-    ;
-    auto borderRay =
-      pul::physics::IntersectorRay::Construct(
-        glm::round(glm::vec2(point0) + playerOrigin)
-      , glm::round(glm::vec2(point1) + playerOrigin)
-      );
-
-    pul::physics::IntersectionResults borderResults;
-    plugin::physics::IntersectionRaycast(scene, borderRay, borderResults);
-
-    if (borderResults.collision) {
-      player.wallClingLeft = true;
-    }
-  }
+  player.wallClingLeft  = borderResults[2].collision;
+  player.wallClingRight = borderResults[1].collision;
 
   player.prevOrigin = playerOrigin;
 }
@@ -594,11 +511,15 @@ void UpdatePlayerWeapon(
   auto const & weaponMatrix =
     playerAnim
       .instance
-      .pieceToState["weapon-placeholder"]
+      .PieceState(playerAnim.instance.gameplayPieces.weaponPlaceholder)
       .cachedLocalSkeletalMatrix
   ;
 
-  bool const weaponFlip = playerAnim.instance.pieceToState["legs"].flip;
+  bool const weaponFlip =
+    playerAnim
+      .instance
+      .PieceState(playerAnim.instance.gameplayPieces.legs)
+      .flip;
 
   if (weapon.cooldown > 0.0f) {
     weapon.cooldown -= pul::util::MsPerFrame;
@@ -748,6 +669,10 @@ void plugin::entity::ConstructPlayer(
   plugin::animation::ConstructInstance(
     scene, instance, scene.AnimationSystem(), "nygelstromn"
   );
+
+  // weapons & hitscans are placed from the weapon-placeholder matrix
+  instance.alwaysComputeCachedMatrix = true;
+
   registry.emplace<pul::animation::ComponentInstance>(
     entity, std::move(instance)
   );
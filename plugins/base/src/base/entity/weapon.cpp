@@ -19,6 +19,8 @@
 
 #include <entt/entt.hpp>
 
+#include <array>
+
 // TODO
 // we have many unused parameters, probably have to change this to a
 // struct-based API in order to not have to deal with this anymore
@@ -27,6 +29,10 @@
 
 namespace {
 
+// entities hit by WeaponDamageCircle, kept around so the entity list keeps its
+// capacity between explosions
+pul::physics::EntityIntersectionResults damageCircleResults;
+
 struct ComponentZeusStingerSecondary {};
 struct ComponentBadFetusSecondary {};
 
@@ -44,7 +50,7 @@ void CreateBadFetusLinkedBeam(
   auto origin = playerOrigin + glm::vec2(0, 28.0f);
 
   auto const & weaponState =
-    playerAnim.pieceToState["weapon-placeholder"];
+    playerAnim.PieceState("weapon-placeholder");
   auto const & weaponMatrix = weaponState.cachedLocalSkeletalMatrix;
 
   namespace config = plugin::config::badFetus::combo;
@@ -59,7 +65,7 @@ void CreateBadFetusLinkedBeam(
     plugin::animation::ConstructInstance(
       scene, instance, scene.AnimationSystem(), "bad-fetus-link-muzzle-flash"
     );
-    auto & state = instance.pieceToState["particle"];
+    auto & state = instance.PieceState("particle");
     state.Apply("bad-fetus-link-muzzle-flash", true);
     state.angle = player.lookAtAngle;
     state.flip = weaponState.flip;
@@ -85,7 +91,7 @@ void CreateBadFetusLinkedBeam(
       scene, instance, scene.AnimationSystem()
     , "bad-fetus-linked-ball-projectile"
     );
-    auto & state = instance.pieceToState["particle"];
+    auto & state = instance.PieceState("particle");
     state.Apply("bad-fetus-linked-ball-projectile", true);
     state.angle = 0.0f;
     state.flip = false;
@@ -106,7 +112,7 @@ void CreateBadFetusLinkedBeam(
       scene, instance, scene.AnimationSystem()
     , "bad-fetus-link-beam"
     );
-    auto & state = instance.pieceToState["particle"];
+    auto & state = instance.PieceState("particle");
     state.Apply("bad-fetus-link-beam", true);
     instance.origin = playerOrigin + glm::vec2(0.0f, 28.0f);
     state.flip = weaponState.flip;
@@ -155,7 +161,7 @@ void CreateBadFetusLinkedBeam(
                 scene, instance, scene.AnimationSystem()
               , "bad-fetus-linked-ball-projectile"
               );
-              auto & state = instance.pieceToState["particle"];
+              auto & state = instance.PieceState("particle");
               state.Apply("bad-fetus-linked-ball-projectile", true);
               state.angle = 0.0f;
               state.flip = false;
@@ -177,7 +183,7 @@ void CreateBadFetusLinkedBeam(
 
                 particleGrenade
                   .animationInstance
-                  .pieceToState["particle"]
+                  .PieceState("particle")
                   .Apply("bad-fetus-explosion", true);
 
                 particleGrenade.origin = animComponent.instance.origin;
@@ -213,13 +219,15 @@ void CreateBadFetusLinkedBeam(
 
         // -- update animation origin/direction
         auto const & weaponStatePlaceholder =
-          playerAnim.pieceToState["weapon-placeholder"];
+          playerAnim.PieceState(playerAnim.gameplayPieces.weaponPlaceholder);
 
-        bool const weaponFlip = playerAnim.pieceToState["legs"].flip;
+        bool const weaponFlip =
+          playerAnim.PieceState(playerAnim.gameplayPieces.legs).flip;
 
         animInstance.origin = playerOrigin + glm::vec2(0.0f, 28.0f);
 
-        auto & animState = animInstance.pieceToState["particle"];
+        auto & animState =
+          animInstance.PieceState(animInstance.gameplayPieces.particle);
         animState.flip = weaponFlip;
 
         auto const & weaponMatrixPlaceholder =
@@ -255,7 +263,9 @@ void CreateBadFetusLinkedBeam(
 
         if (
           pul::physics::IntersectionResults resultsBeam;
-          plugin::physics::IntersectionRaycast(scene, beamRay, resultsBeam)
+          plugin::physics::IntersectionRaycast(
+            plugin::physics::World(), beamRay, resultsBeam
+          )
         ) {
           intersection = true;
           endOrigin = resultsBeam.origin;
@@ -345,7 +355,7 @@ void GrannibalMuzzleTrail(
   plugin::animation::ConstructInstance(
     scene, instance, scene.AnimationSystem(), "grannibal-fire"
   );
-  auto & state = instance.pieceToState["particle"];
+  auto & state = instance.PieceState("particle");
   state.Apply("grannibal-fire", true);
   state.angle = 0.0f;
   state.flip = flip;
@@ -503,7 +513,7 @@ void plugin::entity::FireVolniasPrimary(
     plugin::animation::ConstructInstance(
       scene, instance, scene.AnimationSystem(), "volnias-fire"
     );
-    auto & state = instance.pieceToState["particle"];
+    auto & state = instance.PieceState("particle");
     state.Apply("volnias-fire", true);
     state.angle = angle;
     state.flip = flip;
@@ -524,7 +534,7 @@ void plugin::entity::FireVolniasPrimary(
     plugin::animation::ConstructInstance(
       scene, instance, scene.AnimationSystem(), "volnias-projectile"
     );
-    auto & state = instance.pieceToState["particle"];
+    auto & state = instance.PieceState("particle");
     state.Apply("volnias-projectile", true);
     state.angle = angle;
     state.flip = flip;
@@ -558,7 +568,7 @@ void plugin::entity::FireVolniasPrimary(
 
     exploder
       .animationInstance
-      .pieceToState["particle"].Apply("volnias-hit", true);
+      .PieceState("particle").Apply("volnias-hit", true);
 
     exploder.audioTrigger = &scene.AudioSystem().volniasHit;
 
@@ -670,7 +680,7 @@ void plugin::entity::FireGrannibalPrimary(
     plugin::animation::ConstructInstance(
       scene, instance, scene.AnimationSystem(), "grannibal-projectile"
     );
-    auto & state = instance.pieceToState["particle"];
+    auto & state = instance.PieceState("particle");
     state.Apply("grannibal-projectile", true);
     state.angle = angle;
     state.flip = flip;
@@ -689,7 +699,7 @@ void plugin::entity::FireGrannibalPrimary(
 
       emitter
         .animationInstance
-        .pieceToState["particle"]
+        .PieceState("particle")
         .Apply("grannibal-primary-projectile-trail", true);
 
       // -- timer
@@ -728,7 +738,7 @@ void plugin::entity::FireGrannibalPrimary(
 
     exploder
       .animationInstance
-      .pieceToState["particle"].Apply("grannibal-hit", true);
+      .PieceState("particle").Apply("grannibal-hit", true);
 
     registry.emplace<pul::core::ComponentParticleExploder>(
       grannibalProjectileEntity, std::move(exploder)
@@ -757,7 +767,7 @@ void plugin::entity::FireGrannibalSecondary(
     plugin::animation::ConstructInstance(
       scene, instance, scene.AnimationSystem(), "grannibal-secondary-projectile"
     );
-    auto & state = instance.pieceToState["particle"];
+    auto & state = instance.PieceState("particle");
     state.Apply("grannibal-secondary-projectile", true);
     state.angle = angle;
     state.flip = flip;
@@ -775,7 +785,7 @@ void plugin::entity::FireGrannibalSecondary(
 
       emitter
         .animationInstance
-        .pieceToState["particle"]
+        .PieceState("particle")
         .Apply("grannibal-secondary-projectile-trail", true);
 
       // -- timer
@@ -807,7 +817,7 @@ void plugin::entity::FireGrannibalSecondary(
 
     particle
       .animationInstance
-      .pieceToState["particle"].Apply("grannibal-hit", true);
+      .PieceState("particle").Apply("grannibal-hit", true);
 
     particle.origin = instance.origin;
     particle.velocity = direction*config::ProjectileVelocity();
@@ -882,7 +892,7 @@ void plugin::entity::FireDopplerBeamPrimary(
     plugin::animation::ConstructInstance(
       scene, instance, scene.AnimationSystem(), "doppler-beam-fire"
     );
-    auto & state = instance.pieceToState["particle"];
+    auto & state = instance.PieceState("particle");
     state.Apply("doppler-beam-fire", true);
     state.angle = angle;
     state.flip = flip;
@@ -903,7 +913,7 @@ void plugin::entity::FireDopplerBeamPrimary(
     plugin::animation::ConstructInstance(
       scene, instance, scene.AnimationSystem(), "doppler-beam-projectile"
     );
-    auto & state = instance.pieceToState["particle"];
+    auto & state = instance.PieceState("particle");
     state.Apply("doppler-beam-projectile", true);
     state.angle = angle;
     state.flip = flip;
@@ -930,7 +940,7 @@ void plugin::entity::FireDopplerBeamPrimary(
 
       emitter
         .animationInstance
-        .pieceToState["particle"]
+        .PieceState("particle")
         .Apply("doppler-beam-projectile-trail", true);
 
       // -- timer
@@ -960,7 +970,7 @@ void plugin::entity::FireDopplerBeamPrimary(
 
     exploder
       .animationInstance
-      .pieceToState["particle"].Apply("doppler-beam-hit", true);
+      .PieceState("particle").Apply("doppler-beam-hit", true);
 
     registry.emplace<pul::core::ComponentParticleExploder>(
       dopplerBeamProjectileEntity, std::move(exploder)
@@ -1069,7 +1079,7 @@ void plugin::entity::FirePericaliyaPrimary(
     plugin::animation::ConstructInstance(
       scene, instance, scene.AnimationSystem(), "pericaliya-muzzle"
     );
-    auto & state = instance.pieceToState["particle"];
+    auto & state = instance.PieceState("particle");
     state.Apply("pericaliya-muzzle", true);
     state.angle = angle;
     state.flip = flip;
@@ -1090,7 +1100,7 @@ void plugin::entity::FirePericaliyaPrimary(
     plugin::animation::ConstructInstance(
       scene, instance, scene.AnimationSystem(), "pericaliya-primary-projectile"
     );
-    auto & state = instance.pieceToState["particle"];
+    auto & state = instance.PieceState("particle");
     state.Apply("pericaliya-primary-projectile", true);
     state.angle = angle;
     state.flip = flip;
@@ -1108,7 +1118,7 @@ void plugin::entity::FirePericaliyaPrimary(
 
       emitter
         .animationInstance
-        .pieceToState["particle"]
+        .PieceState("particle")
         .Apply("pericaliya-primary-projectile-trail", true);
 
       // -- timer
@@ -1153,6 +1163,8 @@ void plugin::entity::FirePericaliyaPrimary(
     exploder.damage.explosionForce     = config::ProjectileExplosionForce();
     exploder.damage.playerSplashDamage = config::ProjectileSplashDamageMax();
     exploder.damage.playerDirectDamage = config::ProjectileDirectDamage();
+    exploder.collisionRadius =
+      static_cast<float>(config::ProjectileCollisionRadius());
 
     plugin::animation::ConstructInstance(
       scene, exploder.animationInstance, scene.AnimationSystem()
@@ -1161,7 +1173,7 @@ void plugin::entity::FirePericaliyaPrimary(
 
     exploder
       .animationInstance
-      .pieceToState["particle"].Apply("pericaliya-primary-explosion", true);
+      .PieceState("particle").Apply("pericaliya-primary-explosion", true);
 
     registry.emplace<pul::core::ComponentParticleExploder>(
       pericaliyaProjectileEntity, std::move(exploder)
@@ -1198,7 +1210,7 @@ void plugin::entity::FirePericaliyaSecondary(
       plugin::animation::ConstructInstance(
         scene, instance, scene.AnimationSystem(), "pericaliya-muzzle"
       );
-      auto & state = instance.pieceToState["particle"];
+      auto & state = instance.PieceState("particle");
       state.Apply("pericaliya-muzzle", true);
       state.angle = fireAngle;
       state.flip = flip;
@@ -1220,7 +1232,7 @@ void plugin::entity::FirePericaliyaSecondary(
         scene, instance, scene.AnimationSystem()
       , "pericaliya-secondary-projectile"
       );
-      auto & state = instance.pieceToState["particle"];
+      auto & state = instance.PieceState("particle");
       state.Apply("pericaliya-secondary-projectile", true);
       state.angle = fireAngle;
       state.flip = flip;
@@ -1238,7 +1250,7 @@ void plugin::entity::FirePericaliyaSecondary(
 
         emitter
           .animationInstance
-          .pieceToState["particle"]
+          .PieceState("particle")
           .Apply("pericaliya-secondary-projectile-trail", true);
 
         // -- timer
@@ -1304,7 +1316,7 @@ void plugin::entity::FirePericaliyaSecondary(
 
       exploder
         .animationInstance
-        .pieceToState["particle"].Apply("pericaliya-secondary-explosion", true);
+        .PieceState("particle").Apply("pericaliya-secondary-explosion", true);
 
       registry.emplace<pul::core::ComponentParticleExploder>(
         pericaliyaProjectileEntity, std::move(exploder)
@@ -1375,7 +1387,7 @@ void plugin::entity::FireZeusStingerPrimary(
       scene, animInstance, scene.AnimationSystem()
     , "zeus-stinger-primary-beam-muzzle-flash"
     );
-    auto & animState = animInstance.pieceToState["particle"];
+    auto & animState = animInstance.PieceState("particle");
     animState.Apply("zeus-stinger-primary-beam-muzzle-flash", true);
     animState.flip = flip;
     animInstance.origin = origin + glm::vec2(0.0f, 32.0f);
@@ -1412,7 +1424,7 @@ void plugin::entity::FireZeusStingerPrimary(
         scene, animInstance, scene.AnimationSystem()
       , "zeus-stinger-primary-beam"
       );
-      auto & animState = animInstance.pieceToState["particle"];
+      auto & animState = animInstance.PieceState("particle");
       animState.Apply("zeus-stinger-primary-beam", true);
 
       // -- update animation origin/direction
@@ -1466,7 +1478,9 @@ void plugin::entity::FireZeusStingerPrimary(
         );
       if (
         pul::physics::IntersectionResults resultsBeam;
-        plugin::physics::IntersectionRaycast(scene, beamRay, resultsBeam)
+        plugin::physics::IntersectionRaycast(
+          plugin::physics::World(), beamRay, resultsBeam
+        )
       ) {
         intersection = true;
         endOrigin = resultsBeam.origin;
@@ -1553,7 +1567,7 @@ void plugin::entity::FireZeusStingerPrimary(
         pul::animation::ComponentInstance
       >(zeusStingerBeamEntity).instance
     ;
-    auto & animState = animInstance.pieceToState["particle"];
+    auto & animState = animInstance.PieceState("particle");
 
     // -- apply clipping
     float clipLength =
@@ -1577,7 +1591,7 @@ void plugin::entity::FireZeusStingerPrimary(
           pul::animation::ComponentInstance
         >(zeusStingerMuzzleEntity).instance
       ;
-      auto & muzzleAnimState = muzzleAnimInstance.pieceToState["particle"];
+      auto & muzzleAnimState = muzzleAnimInstance.PieceState("particle");
 
       // TODO don't hardcode
       muzzleAnimState.uvCoordWrap.x = clipLength / 128.0f;
@@ -1601,7 +1615,7 @@ void plugin::entity::FireZeusStingerPrimary(
       plugin::animation::ConstructInstance(
         scene, instance, scene.AnimationSystem(), explosionStr
       );
-      auto & state = instance.pieceToState["particle"];
+      auto & state = instance.PieceState("particle");
       state.Apply(explosionStr, true);
       state.angle = 0.0f;
       state.flip = flip;
@@ -1624,7 +1638,7 @@ void plugin::entity::FireZeusStingerPrimary(
         scene, animInstance, scene.AnimationSystem()
       , "zeus-stinger-scatter-beam"
       );
-      auto & animState = animInstance.pieceToState["particle"];
+      auto & animState = animInstance.PieceState("particle");
       animState.Apply("zeus-stinger-scatter-beam", true);
 
       // -- update animation origin/direction
@@ -1696,7 +1710,7 @@ void plugin::entity::FireZeusStingerSecondary(
         scene, instance, scene.AnimationSystem()
       , "zeus-stinger-secondary-projectile"
       );
-      auto & state = instance.pieceToState["particle"];
+      auto & state = instance.PieceState("particle");
       state.Apply("zeus-stinger-secondary-projectile", true);
       state.angle = angle;
       state.flip = flip;
@@ -1724,7 +1738,7 @@ void plugin::entity::FireZeusStingerSecondary(
 
       particle
         .animationInstance
-        .pieceToState["particle"]
+        .PieceState("particle")
         .Apply("zeus-stinger-secondary-explosion", true);
 
       particle.origin = instance.origin;
@@ -1816,7 +1830,7 @@ void plugin::entity::FireBadFetusPrimary(
     plugin::animation::ConstructInstance(
       scene, instance, scene.AnimationSystem(), "bad-fetus-primary-muzzle-flash"
     );
-    auto & state = instance.pieceToState["particle"];
+    auto & state = instance.PieceState("particle");
     state.Apply("bad-fetus-primary-muzzle-flash", true);
     state.angle = angle;
     state.flip = flip;
@@ -1840,7 +1854,7 @@ void plugin::entity::FireBadFetusPrimary(
       scene, instance, scene.AnimationSystem()
     , "bad-fetus-primary-beam"
     );
-    auto & state = instance.pieceToState["particle"];
+    auto & state = instance.PieceState("particle");
     state.Apply("bad-fetus-primary-beam", true);
     instance.origin = origin;
     state.flip = flip;
@@ -1876,14 +1890,15 @@ void plugin::entity::FireBadFetusPrimary(
 
         // -- update animation origin/direction
         auto const & weaponState =
-          playerAnim
-            .pieceToState["weapon-placeholder"];
+          playerAnim.PieceState(playerAnim.gameplayPieces.weaponPlaceholder);
 
-        bool const weaponFlip = playerAnim.pieceToState["legs"].flip;
+        bool const weaponFlip =
+          playerAnim.PieceState(playerAnim.gameplayPieces.legs).flip;
 
         animInstance.origin = playerOrigin + glm::vec2(0.0f, 32.0f);
 
-        auto & animState = animInstance.pieceToState["particle"];
+        auto & animState =
+          animInstance.PieceState(animInstance.gameplayPieces.particle);
         animState.flip = weaponFlip;
 
         auto const & weaponMatrix = weaponState.cachedLocalSkeletalMatrix;
@@ -1921,7 +1936,9 @@ void plugin::entity::FireBadFetusPrimary(
           );
         if (
           pul::physics::IntersectionResults resultsBeam;
-          plugin::physics::IntersectionRaycast(scene, beamRay, resultsBeam)
+          plugin::physics::IntersectionRaycast(
+            plugin::physics::World(), beamRay, resultsBeam
+          )
         ) {
           endOrigin = resultsBeam.origin;
           hasHit = true;
@@ -1975,7 +1992,7 @@ void plugin::entity::FireBadFetusPrimary(
               scene, instance, scene.AnimationSystem()
             , "bad-fetus-primary-hit-trail"
             );
-            auto & state = instance.pieceToState["particle"];
+            auto & state = instance.PieceState("particle");
             state.Apply("bad-fetus-primary-hit-trail", true);
 
             // origin is where we collided but a few pixels towards player
@@ -2070,7 +2087,7 @@ void plugin::entity::FireBadFetusSecondary(
     plugin::animation::ConstructInstance(
       scene, instance, scene.AnimationSystem(), "bad-fetus-primary-muzzle-flash"
     );
-    auto & state = instance.pieceToState["particle"];
+    auto & state = instance.PieceState("particle");
     state.Apply("bad-fetus-primary-muzzle-flash", true);
     state.angle = angle;
     state.flip = flip;
@@ -2097,7 +2114,7 @@ void plugin::entity::FireBadFetusSecondary(
       scene, instance, scene.AnimationSystem()
     , "bad-fetus-secondary-projectile"
     );
-    auto & state = instance.pieceToState["particle"];
+    auto & state = instance.PieceState("particle");
     state.Apply("bad-fetus-secondary-projectile", true);
     state.angle = angle;
     state.flip = flip;
@@ -2124,7 +2141,7 @@ void plugin::entity::FireBadFetusSecondary(
 
       particle
         .animationInstance
-        .pieceToState["particle"]
+        .PieceState("particle")
         .Apply("bad-fetus-explosion", true);
 
       particle.origin = instance.origin;
@@ -2151,7 +2168,7 @@ void plugin::entity::FireBadFetusSecondary(
 
       emitter
         .animationInstance
-        .pieceToState["particle"]
+        .PieceState("particle")
         .Apply("bad-fetus-secondary-projectile-trail", true);
 
       // -- timer
@@ -2300,7 +2317,7 @@ void plugin::entity::FireManshredderPrimary(
       plugin::animation::ConstructInstance(
         scene, instance, scene.AnimationSystem(), "manshredder-primary-fire"
       );
-      auto & state = instance.pieceToState["particle"];
+      auto & state = instance.PieceState("particle");
       state.Apply("manshredder-primary-fire", true);
       state.angle = angle;
       state.flip = flip;
@@ -2331,7 +2348,7 @@ void plugin::entity::FireManshredderPrimary(
           registry.get<pul::animation::ComponentInstance>(
             manshredderProjectileEntity
           ).instance;
-        auto & state = animation.pieceToState.at("particle");
+        auto & state = animation.PieceState(animation.gameplayPieces.particle);
 
         { // update origin/animation
           animation.origin = playerOrigin + glm::vec2(0.0f, 28.0f);
@@ -2346,33 +2363,33 @@ void plugin::entity::FireManshredderPrimary(
 
         if (state.label != "manshredder-primary-hit")
         { // update hit
-          auto ray =
+          pul::physics::IntersectorEntityRay intersector;
+          intersector.ray =
             pul::physics::IntersectorRay::Construct(
               origin
             , origin+direction*static_cast<float>(config::ProjectileDistance())
             );
-          float dist = config::ProjectileDistance();
-          bool hasHit = false;
-          if (
-            pul::physics::IntersectionResults results;
-            plugin::physics::IntersectionRaycast(scene, ray, results)
-          ) {
-            hasHit = true;
-            dist = glm::length(glm::vec2(results.origin) - origin);
-          }
-
-          // apply weapon damage, clamped by previous environment check
-          hasHit |=
-            plugin::entity::WeaponDamageRaycast(
-              scene
-            , origin
-            , origin + direction*dist
-            , config::ProjectileDamage()
-            , config::ProjectileForce()
-            , playerEntity // ignored player
-            ).entity != entt::null
+          intersector.ignoredEntity = playerEntity;
+          intersector.stopAtLayer = true;
+          intersector.damageableOnly = true;
+
+          // nearest damageable entity in front of the environment takes the
+          // damage, it only counts as a hit once the damage is applied
+          std::array<pul::physics::EntityRaycastHit, 1ul> hits;
+          pul::physics::IntersectionResults layerResults;
+          bool hasHit =
+              plugin::physics::EntityIntersectionRaycastSorted(
+                plugin::physics::World(), scene, intersector, hits
+              , layerResults
+              ) > 0ul
+           && plugin::entity::WeaponDamageEntity(
+                scene, hits[0].entity, direction
+              , config::ProjectileDamage(), config::ProjectileForce()
+              )
           ;
 
+          hasHit |= layerResults.collision;
+
           state.Apply(
             hasHit ? "manshredder-primary-hit" : "manshredder-primary-fire"
           );
@@ -2410,7 +2427,7 @@ void plugin::entity::FireManshredderSecondary(
     plugin::animation::ConstructInstance(
       scene, instance, scene.AnimationSystem(), "manshredder-secondary-fire"
     );
-    auto & state = instance.pieceToState["particle"];
+    auto & state = instance.PieceState("particle");
     state.Apply("manshredder-secondary-fire", true);
     state.angle = angle;
     state.flip = flip;
@@ -2432,7 +2449,7 @@ void plugin::entity::FireManshredderSecondary(
       scene, instance, scene.AnimationSystem()
     , "manshredder-secondary-projectile"
     );
-    auto & state = instance.pieceToState["particle"];
+    auto & state = instance.PieceState("particle");
     state.Apply("manshredder-secondary-projectile", true);
     state.angle = angle;
     state.flip = flip;
@@ -2450,7 +2467,7 @@ void plugin::entity::FireManshredderSecondary(
 
       emitter
         .animationInstance
-        .pieceToState["particle"]
+        .PieceState("particle")
         .Apply("manshredder-secondary-projectile", true);
 
       // -- timer
@@ -2491,7 +2508,7 @@ void plugin::entity::FireManshredderSecondary(
 
     exploder
       .animationInstance
-      .pieceToState["particle"].Apply("manshredder-secondary-hit", true);
+      .PieceState("particle").Apply("manshredder-secondary-hit", true);
 
     registry.emplace<pul::core::ComponentParticleExploder>(
       manshredderProjectileEntity, std::move(exploder)
@@ -2559,7 +2576,7 @@ void plugin::entity::FireWallbangerPrimary(
     plugin::animation::ConstructInstance(
       scene, instance, scene.AnimationSystem(), "wallbanger-primary-muzzle"
     );
-    auto & state = instance.pieceToState["particle"];
+    auto & state = instance.PieceState("particle");
     state.Apply("wallbanger-primary-muzzle", true);
     state.angle = angle;
     state.flip = flip;
@@ -2581,7 +2598,7 @@ void plugin::entity::FireWallbangerPrimary(
       scene, instance, scene.AnimationSystem()
     , "wallbanger-primary-projectile"
     );
-    auto & state = instance.pieceToState["particle"];
+    auto & state = instance.PieceState("particle");
     state.Apply("wallbanger-primary-projectile", true);
     state.angle = angle;
     state.flip = flip;
@@ -2608,7 +2625,7 @@ void plugin::entity::FireWallbangerPrimary(
 
       particle
         .animationInstance
-        .pieceToState["particle"]
+        .PieceState("particle")
         .Apply("wallbanger-primary-explosion", true);
 
       particle.origin = instance.origin;
@@ -2648,7 +2665,7 @@ void plugin::entity::FireWallbangerSecondary(
       scene, instance, scene.AnimationSystem()
     , "wallbanger-secondary-muzzle-big"
     );
-    auto & state = instance.pieceToState["particle"];
+    auto & state = instance.PieceState("particle");
     state.Apply("wallbanger-secondary-muzzle-big", true);
     state.angle = angle;
     state.flip = flip;
@@ -2674,7 +2691,7 @@ void plugin::entity::FireWallbangerSecondary(
       scene, instance, scene.AnimationSystem()
     , "wallbanger-secondary-muzzle-small"
     );
-    auto & state = instance.pieceToState["particle"];
+    auto & state = instance.PieceState("particle");
     state.Apply("wallbanger-secondary-muzzle-small", true);
     state.angle = angle;
     state.flip = flip;
@@ -2711,7 +2728,9 @@ void plugin::entity::FireWallbangerSecondary(
       pul::physics::IntersectorRay::Construct(beginOrigin, endOrigin);
     if (
       pul::physics::IntersectionResults resultsBeam;
-      !plugin::physics::IntersectionRaycast(scene, beamRay, resultsBeam)
+      !plugin::physics::IntersectionRaycast(
+        plugin::physics::World(), beamRay, resultsBeam
+      )
     ) {
       return;
     } else {
@@ -2724,7 +2743,9 @@ void plugin::entity::FireWallbangerSecondary(
     beamRay = pul::physics::IntersectorRay::Construct(beginOrigin, endOrigin);
     if (
       pul::physics::IntersectionResults resultsBeam;
-      plugin::physics::InverseSceneIntersectionRaycast(scene, beamRay, resultsBeam)
+      plugin::physics::InverseSceneIntersectionRaycast(
+        plugin::physics::World(), beamRay, resultsBeam
+      )
     ) {
       endOrigin = glm::vec2(resultsBeam.origin);
     }
@@ -2744,7 +2765,7 @@ void plugin::entity::FireWallbangerSecondary(
     plugin::animation::ConstructInstance(
       scene, instance, scene.AnimationSystem(), "wallbanger-wall-muzzle"
     );
-    auto & state = instance.pieceToState["particle"];
+    auto & state = instance.PieceState("particle");
     state.Apply("wallbanger-wall-muzzle", true);
     state.angle = angle;
     state.flip = flip;
@@ -2763,7 +2784,7 @@ void plugin::entity::FireWallbangerSecondary(
         scene, animInstance, scene.AnimationSystem()
       , "wallbanger-secondary-wall-beam"
       );
-      auto & animState = animInstance.pieceToState["particle"];
+      auto & animState = animInstance.PieceState("particle");
       animState.Apply("wallbanger-secondary-wall-beam", true);
 
       // -- update animation origin/direction
@@ -2798,7 +2819,7 @@ void plugin::entity::FireWallbangerSecondary(
       pul::animation::ComponentInstance
     >(wallbangerBeamEntity).instance
   ;
-  auto & animState = animInstance.pieceToState["particle"];
+  auto & animState = animInstance.PieceState("particle");
 
   // -- apply clipping
   float clipLength =
@@ -2831,7 +2852,7 @@ void plugin::entity::FireWallbangerSecondary(
     plugin::animation::ConstructInstance(
       scene, instance, scene.AnimationSystem(), explosionStr
     );
-    auto & state = instance.pieceToState["particle"];
+    auto & state = instance.PieceState("particle");
     state.Apply(explosionStr, true);
     state.angle = 0.0f;
     state.flip = flip;
@@ -2844,6 +2865,25 @@ void plugin::entity::FireWallbangerSecondary(
   }
 }
 
+bool plugin::entity::WeaponDamageEntity(
+  pul::core::SceneBundle & scene
+, entt::entity entity
+, glm::vec2 const & direction
+, float const damage, float const force
+) {
+  auto * damageable =
+    scene.EnttRegistry().try_get<pul::core::ComponentDamageable>(entity);
+  if (!damageable) { return false; }
+
+  pul::core::DamageInfo damageInfo;
+  damageInfo.directionForce = direction * force;
+  damageInfo.damage = damage;
+
+  damageable->frameDamageInfos.emplace_back(damageInfo);
+
+  return true;
+}
+
 plugin::entity::WeaponDamageRaycastReturnInfo
 plugin::entity::WeaponDamageRaycast(
   pul::core::SceneBundle & scene
@@ -2851,41 +2891,29 @@ plugin::entity::WeaponDamageRaycast(
 , float const damage, float const force
 , entt::entity ignoredEntity
 ) {
-  auto & registry = scene.EnttRegistry();
-
-  pul::physics::IntersectorRay ray;
-  ray.beginOrigin = glm::i32vec2(glm::round(originBegin));
-  ray.endOrigin = glm::i32vec2(glm::round(originEnd));
-  pul::physics::EntityIntersectionResults results;
+  pul::physics::IntersectorEntityRay intersector;
+  intersector.ray.beginOrigin = glm::i32vec2(glm::round(originBegin));
+  intersector.ray.endOrigin = glm::i32vec2(glm::round(originEnd));
+  intersector.ignoredEntity = ignoredEntity;
+  intersector.damageableOnly = true;
 
   plugin::entity::WeaponDamageRaycastReturnInfo ri = {};
 
-  // iterate thru all entity intersections, and if damageable record
-  // the damage
-  plugin::physics::EntityIntersectionRaycast(scene, ray, results);
-  for (auto & entityIntersection : results.entities) {
-    auto * damageable =
-      registry.try_get<pul::core::ComponentDamageable>(
-        std::get<1>(entityIntersection)
-      );
-    if (!damageable) { continue; }
-    if (std::get<1>(entityIntersection) == ignoredEntity) { continue; }
-
-    pul::core::DamageInfo damageInfo;
-    { // calculate damage info
-      glm::vec2 const dir = glm::normalize(originEnd - originBegin);
-
-      damageInfo.directionForce = dir * force;
-      damageInfo.damage = damage;
-    }
-
-    damageable->frameDamageInfos.emplace_back(damageInfo);
-
-    // only one entity can be hit with ray (at least for now)
-    ri.entity = std::get<1>(entityIntersection);
-    ri.origin = std::get<0>(entityIntersection);
-
-    break;
+  // only one entity can be hit with ray (at least for now), the nearest one
+  // that can take damage
+  std::array<pul::physics::EntityRaycastHit, 1ul> hits;
+  pul::physics::IntersectionResults layerResults;
+  if (
+      plugin::physics::EntityIntersectionRaycastSorted(
+        plugin::physics::World(), scene, intersector, hits, layerResults
+      ) > 0ul
+   && plugin::entity::WeaponDamageEntity(
+        scene, hits[0].entity
+      , glm::normalize(originEnd - originBegin), damage, force
+      )
+  ) {
+    ri.entity = hits[0].entity;
+    ri.origin = hits[0].origin;
   }
 
   return ri;
@@ -2903,20 +2931,19 @@ bool plugin::entity::WeaponDamageCircle(
   pul::physics::IntersectorCircle circle;
   circle.origin = origin;
   circle.radius = radius;
-  pul::physics::EntityIntersectionResults results;
 
   // iterate thru all entity intersections, and if damageable record
   // the damage
+  auto & results = ::damageCircleResults;
   plugin::physics::EntityIntersectionCircle(scene, circle, results);
+
   bool hasHit = false;
-  for (auto & entityIntersection : results.entities) {
+  for (auto const & [intersectionOrigin, entity] : results.entities) {
     auto * damageable =
-      registry.try_get<pul::core::ComponentDamageable>(
-        std::get<1>(entityIntersection)
-      );
+      registry.try_get<pul::core::ComponentDamageable>(entity);
     if (!damageable) { continue; }
 
-    if (std::get<1>(entityIntersection) == ignoredEntity) { continue; }
+    if (entity == ignoredEntity) { continue; }
 
     hasHit = true;
 
@@ -2926,7 +2953,7 @@ bool plugin::entity::WeaponDamageCircle(
 
       // if there is no override, use angle between target/hitbox-center
       if (dir == glm::vec2(0.0f))
-        glm::vec2(std::get<0>(entityIntersection)) - origin;
+        glm::vec2(intersectionOrigin) - origin;
 
       // just assume up when the direction is 0
       if (dir == glm::vec2(0.0f))
@@ -14,13 +14,29 @@
 
 #include <glm/glm.hpp>
 
+#include <algorithm>
+#include <array>
+
 namespace {
 
+// animation snapshots of the last two logic frames; the current render bundle
+// refers to one and the previous render bundle to the other, so the next
+// logic frame can overwrite the oldest one in place
+std::array<plugin::animation::AnimationSnapshot, 2> animationSnapshots;
+size_t animationSnapshotIdx = 0ul;
+
+// only one interpolated render bundle is alive at a time
+plugin::animation::AnimationRenderOutput animationRenderOutput;
+
+// instances to snapshot, sorted by entity to be matched during interpolation
+std::vector<std::pair<size_t, pul::animation::Instance const *>>
+  animationSnapshotOrder;
+
 struct BaseRenderBundle {
-  InterpolantMap<plugin::animation::Interpolant> animationInterpolants;
+  plugin::animation::AnimationSnapshot const * animationSnapshot = nullptr;
 
   // only used as output TODO maybe make a different struct for outputs?
-  std::vector<plugin::animation::Interpolant> animationInterpolantOutputs;
+  plugin::animation::AnimationRenderOutput * animationRenderOutput = nullptr;
 
   static void Deallocate(void * data) {
     delete reinterpret_cast<BaseRenderBundle *>(data);
@@ -37,17 +53,13 @@ PUL_PLUGIN_DECL void Plugin_UpdateRenderBundleInstance(
 ) {
   auto & registry = scene.EnttRegistry();
 
-  InterpolantMap<plugin::animation::Interpolant> animationInterpolants;
+  ::animationSnapshotIdx = (::animationSnapshotIdx + 1ul) % 2ul;
+  auto & animationSnapshot = ::animationSnapshots[::animationSnapshotIdx];
+  animationSnapshot.Clear();
 
   { // -- store animation information
 
-    auto cameraOrigin = glm::vec2(scene.cameraOrigin);
-    auto const
-      cullBoundLeft  = cameraOrigin.x - scene.config.framebufferDimFloat.x/2.0f
-    , cullBoundRight = cameraOrigin.x + scene.config.framebufferDimFloat.x/2.0f
-    , cullBoundUp    = cameraOrigin.y - scene.config.framebufferDimFloat.y/2.0f
-    , cullBoundDown  = cameraOrigin.y + scene.config.framebufferDimFloat.y/2.0f
-    ;
+    ::animationSnapshotOrder.clear();
 
     auto view = registry.view<pul::animation::ComponentInstance>();
     for (auto entity : view) {
@@ -56,34 +68,25 @@ PUL_PLUGIN_DECL void Plugin_UpdateRenderBundleInstance(
       if (self.instance.automaticCachedMatrixCalculation)
         { self.instance.hasCalculatedCachedInfo = false; }
 
-      // check if visible / cull / ready to render
-      if (
-          !self.instance.visible
-       || self.instance.drawCallCount == 0ul
-       || cullBoundLeft  > self.instance.origin.x
-       || cullBoundRight < self.instance.origin.x
-       || cullBoundUp    > self.instance.origin.y
-       || cullBoundDown  < self.instance.origin.y
-      ) { continue; }
+      if (!plugin::animation::IsVisible(scene, self.instance)) { continue; }
 
       // DEBUG
       /* debugRenderingInstances.emplace_back(&self.instance); */
 
-      // copy the entire instance
-      auto interpolantCopy = plugin::animation::Interpolant { self.instance };
-      auto & instanceCopy = interpolantCopy.instance;
-
-      // compute cache
-      plugin::animation::ComputeCache(
-        instanceCopy, instanceCopy.animator->skeleton
-      , glm::mat3(1.0f), false, 0.0f
-      );
-
-      // move instance w/ the entity ID
-      animationInterpolants.emplace(
-        static_cast<size_t>(entity), std::move(interpolantCopy)
+      ::animationSnapshotOrder.emplace_back(
+        static_cast<size_t>(entity), &self.instance
       );
     }
+
+    std::sort(
+      ::animationSnapshotOrder.begin(), ::animationSnapshotOrder.end()
+    , [](auto const & a, auto const & b) { return a.first < b.first; }
+    );
+
+    // the skeleton is evaluated during interpolation, so only the state that
+    // it's evaluated from is copied
+    for (auto const & [entity, instancePtr] : ::animationSnapshotOrder)
+      { animationSnapshot.Record(entity, *instancePtr); }
   }
 
   { // -- store data into the instance bundle
@@ -98,7 +101,7 @@ PUL_PLUGIN_DECL void Plugin_UpdateRenderBundleInstance(
     auto & instanceBundleData =
       *reinterpret_cast<::BaseRenderBundle*>(instanceBundleDataAny->userdata);
 
-    instanceBundleData.animationInterpolants = std::move(animationInterpolants);
+    instanceBundleData.animationSnapshot = &animationSnapshot;
   }
 }
 
@@ -116,7 +119,10 @@ PUL_PLUGIN_DECL void Plugin_Interpolate(
   auto & bundleDataOutputAny = outputBundle.pluginBundleData["base"];
   bundleDataOutputAny = std::make_shared<pul::util::Any>();
   bundleDataOutputAny->Deallocate = ::BaseRenderBundle::Deallocate;
-  bundleDataOutputAny->userdata = new ::BaseRenderBundle;
+  bundleDataOutputAny->userdata =
+    new ::BaseRenderBundle {
+      .animationRenderOutput = &::animationRenderOutput
+    };
 
   // -- retrieve baserenderbundle for each
   auto
@@ -131,8 +137,8 @@ PUL_PLUGIN_DECL void Plugin_Interpolate(
   // -- forward rendering information
   plugin::animation::Interpolate(
     msDeltaInterp
-  , previous.animationInterpolants, current.animationInterpolants
-  , output.animationInterpolantOutputs
+  , *previous.animationSnapshot, *current.animationSnapshot
+  , *output.animationRenderOutput
   );
 }
 
@@ -155,7 +161,7 @@ PUL_PLUGIN_DECL void Plugin_RenderInterpolated(
   plugin::animation::RenderInterpolated(
     scene
   , interpolatedBundle
-  , current.animationInterpolantOutputs
+  , *current.animationRenderOutput
   );
 
   plugin::bot::DebugRender();
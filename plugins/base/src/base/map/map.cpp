@@ -672,11 +672,15 @@ void ParseLayerObject(pul::core::SceneBundle & scene , cJSON * layer) {
       );
 
       pickupAnimationInstance.origin = origin;
+
+      // pickups are collided against from their 'pickups' matrix
+      pickupAnimationInstance.alwaysComputeCachedMatrix = true;
+
       pickupAnimationInstance
-        .pieceToState["pickups"].Apply(animationStatePickupStr, true);
+        .PieceState("pickups").Apply(animationStatePickupStr, true);
       if (applyPickupBg) {
         pickupAnimationInstance
-          .pieceToState["pickup-bg"].Apply(animationStatePickupStr, true);
+          .PieceState("pickup-bg").Apply(animationStatePickupStr, true);
       }
 
       registry.emplace<pul::animation::ComponentInstance>(
@@ -778,9 +782,13 @@ void plugin::map::LoadMap(
     { // construct map tileset
       auto image = pul::gfx::Image::Construct(tilesetPath.string().c_str());
 
-      // get plugin to load tileset
+      // get plugin to load tileset, processed tilesets are cached in the
+      // working directory, like the controller config, as the assets may be
+      // read-only
       pul::physics::Tileset physxTileset;
-      plugin::physics::ProcessTileset(physxTileset, image);
+      plugin::physics::LoadTileset(
+        physxTileset, image, "cache/physics-tilesets"
+      );
 
       auto tilesJson = cJSON_GetObjectItemCaseSensitive(tilesetJson, "tiles");
       // copy tilesJson if not null
@@ -967,7 +975,7 @@ void plugin::map::DebugUiDispatch(pul::core::SceneBundle & scene) {
         }
 
         physxStr +=
-          physicsTile.signedDistanceField[i%32][i/32] > 0.0f ? "#" : "-";
+          physicsTile.Solid(i%32, i/32) ? "#" : "-";
       }
 
       pul::imgui::Text("{}", physxStr);
@@ -12,15 +12,29 @@
 #include <pulcher-util/enum.hpp>
 #include <pulcher-util/log.hpp>
 #include <pulcher-util/math.hpp>
+#include <pulcher-util/parallel.hpp>
 
 #include <box2d/box2d.h>
 #include <entt/entt.hpp>
 #include <glad/glad.hpp>
 #include <imgui/imgui.hpp>
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <filesystem>
+#include <fstream>
+#include <limits>
 #include <span>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
+#if defined(__SSE2__)
+  #include <emmintrin.h>
+#endif
+
 namespace Consts {
   constexpr float pixelsToMeters = 0.1f;
   constexpr float metersToPixels = 1.0f/pixelsToMeters;
@@ -111,6 +125,63 @@ struct boxDebugDraw : public b2Draw {
 };
 
 bool showPhysicsQueries = true;
+bool useAcceleratedRaycasts = true;
+
+// transient scratch data of the queries, one per ParallelFor thread as queries
+// may run concurrently. Buffers are only ever cleared, never shrunk, so once
+// they have grown to the largest queries of a session the logic tick doesn't
+// allocate. They're released on shutdown
+struct QueryScratch {
+  // order in which IntersectionRaycastBatch traces its rays, as
+  // (begin tile key, ray idx)
+  std::vector<std::pair<uint64_t, size_t>> batchRayOrder;
+
+  // entities of the visited buckets; entities spanning several cells show up
+  // more than once, so they are sorted & deduplicated before testing
+  std::vector<uint32_t> broadphaseCandidates;
+
+  // mirrored bounds of the candidates gathered contiguously for the ray
+  // kernel, padded to a multiple of its width
+  std::vector<float> rayBoundsMinX, rayBoundsMinY, rayBoundsMaxX, rayBoundsMaxY;
+
+  // entry time of the segment into each gathered hitbox, +inf on a miss; a
+  // segment that begins inside of a box enters it at 0
+  std::vector<float> rayEntryTimes;
+
+  // (entry time, entry idx) of the mirrored hitboxes hit by a segment
+  std::vector<std::pair<float, uint32_t>> rayKernelHits;
+
+  // (entry time, entity) of the hitboxes hit by GatherRayEntityHits
+  std::vector<std::pair<float, entt::entity>> rayEntityHits;
+
+  // (closest origin, entity) of the hitboxes hit by GatherCircleEntityHits
+  std::vector<std::pair<glm::i32vec2, entt::entity>> circleEntityHits;
+
+  size_t CapacityBytes() const {
+    return
+        batchRayOrder.capacity() * sizeof(batchRayOrder[0])
+      + broadphaseCandidates.capacity() * sizeof(broadphaseCandidates[0])
+      + rayBoundsMinX.capacity() * sizeof(rayBoundsMinX[0]) * 4ul
+      + rayEntryTimes.capacity() * sizeof(rayEntryTimes[0])
+      + rayKernelHits.capacity() * sizeof(rayKernelHits[0])
+      + rayEntityHits.capacity() * sizeof(rayEntityHits[0])
+      + circleEntityHits.capacity() * sizeof(circleEntityHits[0])
+    ;
+  }
+};
+
+std::array<QueryScratch, pul::util::maxParallelThreads> queryScratches;
+
+QueryScratch & LocalQueryScratch() {
+  return ::queryScratches[pul::util::ParallelWorkerIdx()];
+}
+
+size_t QueryScratchCapacityBytes() {
+  size_t bytes = 0ul;
+  for (auto const & scratch : ::queryScratches)
+    { bytes += scratch.CapacityBytes(); }
+  return bytes;
+}
 
 std::unique_ptr<b2World> boxWorld;
 boxDebugDraw boxWorldDebugDraw;
@@ -118,38 +189,850 @@ boxDebugDraw boxWorldDebugDraw;
 // basically, when doings physics, we want tile lookups to be cached / quick,
 // and we only want to do one tile intersection test per tile-grid. In other
 // words, while there may be multiple tilesets contributing to the
-// collision layer, there is still only one collision layer
+// collision layer, there is still only one collision layer. Only written by
+// LoadMapGeometry & ClearMapGeometry, queries receive it as const
+pul::physics::PhysicsWorld physicsWorld;
+
+int32_t FloorDiv(int32_t const a, int32_t const b) {
+  return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+glm::i32vec2 FloorDiv(glm::i32vec2 const a, int32_t const b) {
+  return glm::i32vec2(::FloorDiv(a.x, b), ::FloorDiv(a.y, b));
+}
+
+// physics tile of a tile-grid cell with its orientation decoded. Queries keep
+// the last resolved tile around, so consecutive texels & rays that fall into
+// the same tile only fetch & decode it once, and the same chunk is only looked
+// up once
+struct ResolvedTile {
+  glm::i32vec2 tileOrigin = glm::i32vec2(std::numeric_limits<int32_t>::min());
+  glm::i32vec2 chunkOrigin = glm::i32vec2(std::numeric_limits<int32_t>::min());
+  // nullptr if the chunk isn't loaded
+  pul::physics::TilemapLayer::Chunk const * chunk = nullptr;
+  pul::physics::TilemapLayer::TileInfo const * tileInfo = nullptr;
+  pul::physics::Tile const * physicsTile = nullptr; // nullptr if no tile
+  bool flipHorizontal = false, flipVertical = false, flipDiagonal = false;
+
+  // nullptr if the tile's border normals are those of its physics tile
+  std::array<
+    std::array<int8_t, 2>, pul::physics::TilemapLayer::Chunk::seamTexels
+  > const * seamNormals = nullptr;
+};
+
+// tiles resolved by the rays of a batch. The rays of a bundle, such as the
+// border rays of a character, cross the same few tiles & chunks, so each is
+// only looked up & decoded once per batch. Entries are replaced round-robin
+struct ResolvedTileCache {
+  static size_t constexpr capacity = 8ul;
+  std::array<ResolvedTile, capacity> tiles;
+  size_t next = 0ul;
+
+  void Insert(ResolvedTile const & tile) {
+    tiles[next] = tile;
+    next = (next + 1ul) % capacity;
+  }
+};
+
+// returns false if the origin lies in a chunk that isn't loaded, the tile is
+// then resolved as an empty tile. With a cache, tiles & chunks resolved by
+// other queries of the batch are reused
+bool ResolveTile(
+  pul::physics::TilemapLayer const & layer
+, ResolvedTile & tile
+, glm::u32vec2 & texelOrigin
+, glm::i32vec2 const origin
+, ResolvedTileCache * const cache = nullptr
+) {
+  using Layer = pul::physics::TilemapLayer;
+
+  // calculate tile indices, not for the spritesheet but for the tile in
+  // the physx map
+  glm::i32vec2 const tileOrigin = ::FloorDiv(origin, 32);
+  texelOrigin = glm::u32vec2(origin - tileOrigin*32);
+
+  if (tileOrigin == tile.tileOrigin) { return tile.chunk != nullptr; }
+
+  if (cache) {
+    for (auto const & cached : cache->tiles) {
+      if (cached.tileOrigin != tileOrigin) { continue; }
+      tile = cached;
+      return tile.chunk != nullptr;
+    }
+  }
+
+  tile.tileOrigin = tileOrigin;
+
+  glm::i32vec2 const chunkOrigin = ::FloorDiv(tileOrigin, Layer::chunkTiles);
+  if (chunkOrigin != tile.chunkOrigin) {
+    tile.chunkOrigin = chunkOrigin;
+
+    bool chunkCached = false;
+    if (cache) {
+      for (auto const & cached : cache->tiles) {
+        if (cached.chunkOrigin != chunkOrigin) { continue; }
+        tile.chunk = cached.chunk;
+        chunkCached = true;
+        break;
+      }
+    }
+
+    if (!chunkCached) { tile.chunk = layer.FindChunk(chunkOrigin); }
+  }
+
+  if (!tile.chunk) {
+    tile.tileInfo = nullptr;
+    tile.physicsTile = nullptr;
+    tile.flipHorizontal = tile.flipVertical = tile.flipDiagonal = false;
+    tile.seamNormals = nullptr;
+    if (cache) { cache->Insert(tile); }
+    return false;
+  }
+
+  glm::i32vec2 const chunkTile = tileOrigin - chunkOrigin*Layer::chunkTiles;
+  size_t const chunkTileIdx = chunkTile.y*Layer::chunkTiles + chunkTile.x;
+  auto const & tileInfo = tile.chunk->tileInfo[chunkTileIdx];
+
+  tile.tileInfo = &tileInfo;
+  tile.physicsTile =
+    tileInfo.Valid()
+  ? &layer.tilesets[tileInfo.TilesetIdx()]->tiles[tileInfo.ImageTileIdx()]
+  : nullptr
+  ;
+
+  auto const tileOrientation = Idx(tileInfo.Orientation());
+  tile.flipHorizontal =
+    tileOrientation & Idx(pul::core::TileOrientation::FlipHorizontal);
+  tile.flipVertical =
+    tileOrientation & Idx(pul::core::TileOrientation::FlipVertical);
+  tile.flipDiagonal =
+    tileOrientation & Idx(pul::core::TileOrientation::FlipDiagonal);
+
+  uint32_t const seamNormalIdx = tile.chunk->seamNormalIdx[chunkTileIdx];
+  tile.seamNormals =
+    seamNormalIdx == -1u ? nullptr : &tile.chunk->seamNormals[seamNormalIdx];
+
+  if (cache) { cache->Insert(tile); }
+  return true;
+}
+
+uint32_t ReverseBits(uint32_t bits) {
+  bits = ((bits >> 1u) & 0x55555555u) | ((bits & 0x55555555u) << 1u);
+  bits = ((bits >> 2u) & 0x33333333u) | ((bits & 0x33333333u) << 2u);
+  bits = ((bits >> 4u) & 0x0F0F0F0Fu) | ((bits & 0x0F0F0F0Fu) << 4u);
+  bits = ((bits >> 8u) & 0x00FF00FFu) | ((bits & 0x00FF00FFu) << 8u);
+  return (bits >> 16u) | (bits << 16u);
+}
+
+// solid mask of the row (horizontal) or column of texels in world-space that
+// contains the texel, bit i being the i-th texel along the span. Depending on
+// orientation a world row is either a row or a column of the physics tile,
+// and flips along the span reverse the bits
+uint32_t SpanMask(
+  ResolvedTile const & tile
+, glm::u32vec2 const texel
+, bool const horizontal
+) {
+  // no tile is the same as a fully empty tile
+  if (!tile.physicsTile) { return 0u; }
+
+  auto const & physicsTile = *tile.physicsTile;
+
+  if (horizontal) {
+    uint32_t const y = tile.flipVertical ? 31u - texel.y : texel.y;
+    uint32_t const mask =
+      tile.flipDiagonal ? physicsTile.columnMasks[y] : physicsTile.rowMasks[y];
+    return tile.flipHorizontal ? ::ReverseBits(mask) : mask;
+  }
+
+  uint32_t const x = tile.flipHorizontal ? 31u - texel.x : texel.x;
+  uint32_t const mask =
+    tile.flipDiagonal ? physicsTile.rowMasks[x] : physicsTile.columnMasks[x];
+  return tile.flipVertical ? ::ReverseBits(mask) : mask;
+}
+
+bool TexelSolid(ResolvedTile const & tile, glm::u32vec2 const texel) {
+  return (::SpanMask(tile, texel, true) >> texel.x) & 1u;
+}
+
+std::array<int8_t, 2> QuantizeNormal(glm::vec2 normal) {
+  if (normal != glm::vec2(0.0f))
+    { normal = glm::round(glm::normalize(normal) * 127.0f); }
+
+  return { static_cast<int8_t>(normal.x), static_cast<int8_t>(normal.y) };
+}
+
+// unnormalized surface normal of a texel, pointing away from the solid texels
+// within normalRadius; solid(offsetX, offsetY) tests the texel at the offset
+template <typename Fn>
+glm::vec2 NeighbourhoodNormal(Fn && solid) {
+  int32_t constexpr radius =
+    static_cast<int32_t>(pul::physics::Tile::normalRadius);
+
+  glm::vec2 normal = glm::vec2(0.0f);
+  for (int32_t oy = -radius; oy <= radius; ++ oy)
+  for (int32_t ox = -radius; ox <= radius; ++ ox) {
+    if (solid(ox, oy)) { normal -= glm::vec2(ox, oy); }
+  }
+  return normal;
+}
+
+// index of the texel in the seam normals of its tile, -1ul if the texel isn't
+// within normalRadius of the tile border. The two leading rows come first,
+// then the two trailing rows, then the leading & trailing columns of the rows
+// in between
+size_t SeamTexelIdx(glm::u32vec2 const texel) {
+  uint32_t constexpr
+    radius = static_cast<uint32_t>(pul::physics::Tile::normalRadius)
+  , gridSize = static_cast<uint32_t>(pul::physics::Tile::gridSize)
+  , innerSize = gridSize - 2u*radius
+  ;
+
+  if (texel.y < radius) { return texel.y*gridSize + texel.x; }
 
-pul::physics::TilemapLayer tilemapLayer;
+  if (texel.y >= gridSize - radius) {
+    return (radius + texel.y - (gridSize - radius))*gridSize + texel.x;
+  }
+
+  if (texel.x >= radius && texel.x < gridSize - radius) { return -1ul; }
+
+  uint32_t const column = texel.x < radius ? texel.x : texel.x - innerSize;
+  return 2u*radius*gridSize + (texel.y - radius)*2u*radius + column;
+}
 
-float CalculateSdfDistance(
-  pul::physics::TilemapLayer::TileInfo const & tileInfo
-, glm::u32vec2 texel
+// quantized world-space normal of a texel from the tile-space normals of the
+// physics tile, undoing the orientation in reverse order; the diagonal flip
+// is applied last when mapping world texels into the tile
+std::array<int8_t, 2> TileSpaceNormal(
+  ResolvedTile const & tile, glm::u32vec2 const texel
 ) {
-  if (tileInfo.tilesetIdx == -1ul) { return 0.0f; }
+  if (!tile.physicsTile) { return { 0, 0 }; }
 
-  auto const * tileset = tilemapLayer.tilesets[tileInfo.tilesetIdx];
+  uint32_t x = tile.flipHorizontal ? 31u - texel.x : texel.x;
+  uint32_t y = tile.flipVertical   ? 31u - texel.y : texel.y;
+  if (tile.flipDiagonal) { std::swap(x, y); }
 
-  if (!tileInfo.Valid()) { return 0.0f; }
+  auto normal = tile.physicsTile->surfaceNormals[x][y];
 
-  pul::physics::Tile const & physicsTile =
-    tileset->tiles[tileInfo.imageTileIdx];
+  if (tile.flipDiagonal)   { std::swap(normal[0], normal[1]); }
+  if (tile.flipHorizontal) { normal[0] = static_cast<int8_t>(-normal[0]); }
+  if (tile.flipVertical)   { normal[1] = static_cast<int8_t>(-normal[1]); }
+  return normal;
+}
+
+// world-space surface normal at a texel of the tile, zero if its neighbourhood
+// is uniformly solid or empty. Texels near the tile border take the seam
+// normals of the chunk, which see the neighbouring tiles
+glm::vec2 TexelNormal(ResolvedTile const & tile, glm::u32vec2 const texel) {
+  size_t const seamIdx = tile.seamNormals ? ::SeamTexelIdx(texel) : -1ul;
+  auto const normal =
+    seamIdx != -1ul
+  ? (*tile.seamNormals)[seamIdx]
+  : ::TileSpaceNormal(tile, texel)
+  ;
+
+  return glm::vec2(normal[0], normal[1]) / 127.0f;
+}
+
+// results of a query stopping at the origin, which must lie within the tile
+pul::physics::IntersectionResults TileResults(
+  ResolvedTile const & tile
+, glm::i32vec2 const origin
+) {
+  return
+    pul::physics::IntersectionResults {
+      true, origin
+    , tile.tileInfo ? tile.tileInfo->ImageTileIdx() : -1ul
+    , tile.tileInfo ? tile.tileInfo->TilesetIdx() : -1ul
+    , ::TexelNormal(tile, glm::u32vec2(origin - tile.tileOrigin*32))
+    };
+}
+
+// amount of texels from `position` to the first set bit of the mask, walking
+// the mask in direction; -1 if there is none
+int32_t FirstSetBitOffset(
+  uint32_t const mask, uint32_t const position, int64_t const direction
+) {
+  uint32_t const bits =
+    direction > 0 ? (mask >> position) : (mask << (31u - position));
+
+  if (bits == 0u) { return -1; }
+
+  return direction > 0 ? std::countr_zero(bits) : std::countl_zero(bits);
+}
+
+int32_t CalculateSdfDistance(ResolvedTile const & tile, glm::u32vec2 texel) {
+  // no tile is the same as a fully empty tile
+  if (!tile.physicsTile)
+    { return static_cast<int32_t>(pul::physics::Tile::gridSize); }
 
   // apply tile orientation
-  auto const tileOrientation = Idx(tileInfo.orientation);
+  if (tile.flipHorizontal) { texel.x = 31 - texel.x; }
+  if (tile.flipVertical)   { texel.y = 31 - texel.y; }
+  if (tile.flipDiagonal)   { std::swap(texel.x, texel.y); }
+
+  return tile.physicsTile->signedDistanceField[texel.x][texel.y];
+}
+
+// amount of texels a ray can advance along its major axis from the texel
+// without skipping any texel of opposite solidity. The distance field only
+// describes the current tile, so the skip is also clamped to the tile border
+// in the direction of the ray
+int32_t SdfSkipDistance(
+  int32_t const distance
+, glm::u32vec2 const texel
+, glm::i32vec2 const direction
+) {
+  int32_t constexpr gridSize =
+    static_cast<int32_t>(pul::physics::Tile::gridSize);
+
+  int32_t skip = glm::abs(distance);
+
+  for (size_t axis = 0ul; axis < 2ul; ++ axis) {
+    int32_t const texelAxis = static_cast<int32_t>(texel[axis]);
+    if (direction[axis] > 0) { skip = glm::min(skip, gridSize - texelAxis); }
+    if (direction[axis] < 0) { skip = glm::min(skip, texelAxis + 1); }
+  }
+
+  return glm::max(skip, 1);
+}
+
+pul::physics::TileIntersectAccelerationHint TileAccelerationHint(
+  ResolvedTile const & tile
+) {
+  // no tile is the same as a fully empty tile
+  if (!tile.physicsTile)
+    { return pul::physics::TileIntersectAccelerationHint::Empty; }
+
+  return tile.physicsTile->accelerationHint;
+}
+
+// first step past the coarsest occupancy cell of the chunk around the texel at
+// step that can't stop the ray, descending the pyramid only through occupied
+// cells. Returns step itself if even the tile is occupied
+int64_t OccupancySkipStep(
+  pul::physics::TilemapLayer::Chunk const & chunk
+, pul::physics::BresenhamLineParametric const & line
+, int64_t const step
+, bool const inverse
+) {
+  using Layer = pul::physics::TilemapLayer;
+
+  auto const & pyramid = chunk.occupancyPyramid;
+  auto const chunkTexel =
+    glm::u32vec2(line.Texel(step) - chunk.origin*Layer::chunkTexels);
+
+  for (size_t level = pyramid.size(); level-- > 0ul;) {
+    auto const & occupancy = pyramid[level];
+    uint32_t const
+      cellSize = 32u << level
+    , rowCells = static_cast<uint32_t>(Layer::chunkTiles) >> level
+    ;
+    size_t const cellIdx =
+      (chunkTexel.y / cellSize) * rowCells + (chunkTexel.x / cellSize);
+
+    bool const occupied =
+      inverse ? occupancy.empty[cellIdx] : occupancy.solid[cellIdx];
+
+    if (!occupied) { return line.NextCellStep(step, cellSize); }
+  }
+
+  return step;
+}
+
+// hierarchical traversal of the collision layer along the ray. Empty space is
+// skipped through the occupancy pyramid, then tiles are walked with a grid DDA
+// that stops at once on tiles that must stop the ray. In mixed tiles each
+// row/column the ray passes along is tested with a single bit scan, and the
+// distance field skips further when it can. The ray stops at the first solid
+// texel, or the first empty texel when inverse
+void TraceRay(
+  pul::physics::TilemapLayer const & layer
+, pul::physics::IntersectorRay const & ray
+, bool const inverse
+, pul::physics::IntersectionResults & intersectionResults
+, ResolvedTile & tile
+, ResolvedTileCache * const tileCache = nullptr
+) {
+  using Hint = pul::physics::TileIntersectAccelerationHint;
+
+  int64_t constexpr tileSize =
+    static_cast<int64_t>(pul::physics::Tile::gridSize);
+
+  Hint const
+    skipHint = inverse ? Hint::Full : Hint::Empty
+  , stopHint = inverse ? Hint::Empty : Hint::Full
+  ;
+
+  auto const line =
+    pul::physics::BresenhamLineParametric::Construct(
+      ray.beginOrigin, ray.endOrigin
+    );
+
+  auto const rayDirection =
+    glm::i32vec2(glm::sign(glm::vec2(ray.endOrigin - ray.beginOrigin)));
+
+  int64_t constexpr chunkSize =
+    static_cast<int64_t>(pul::physics::TilemapLayer::chunkTexels);
+
+  for (int64_t step = 0; step <= line.Length();) {
+    auto const origin = glm::i32vec2(line.Texel(step));
+
+    glm::u32vec2 texelOrigin;
+    if (!::ResolveTile(layer, tile, texelOrigin, origin, tileCache)) {
+      // chunk isn't loaded, which is empty space up to the next chunk
+      if (inverse) {
+        intersectionResults = ::TileResults(tile, origin);
+        break;
+      }
+
+      step =
+        ::useAcceleratedRaycasts ? line.NextCellStep(step, chunkSize) : step+1;
+      continue;
+    }
+
+    if (::useAcceleratedRaycasts) {
+      int64_t const skipStep =
+        ::OccupancySkipStep(*tile.chunk, line, step, inverse);
+      if (skipStep != step) {
+        step = skipStep;
+        continue;
+      }
+    }
+
+    if (!::useAcceleratedRaycasts) {
+      if (::TexelSolid(tile, texelOrigin) != inverse) {
+        intersectionResults = ::TileResults(tile, origin);
+        break;
+      }
+
+      ++ step;
+      continue;
+    }
+
+    Hint const tileHint = ::TileAccelerationHint(tile);
+
+    if (tileHint == skipHint) {
+      step = line.NextCellStep(step, tileSize);
+      continue;
+    }
+
+    if (tileHint == stopHint) {
+      intersectionResults = ::TileResults(tile, origin);
+      break;
+    }
+
+    // the ray stays on the current row/column of the tile until its minor
+    // axis changes, so scan the span for the first texel that stops the ray
+    uint32_t const spanMask = ::SpanMask(tile, texelOrigin, !line.steep);
+
+    int64_t const spanEnd =
+      glm::min(line.NextMinorStep(step), line.NextCellStep(step, tileSize));
+
+    int32_t const hitOffset =
+      ::FirstSetBitOffset(
+        inverse ? ~spanMask : spanMask
+      , line.steep ? texelOrigin.y : texelOrigin.x
+      , line.stepx
+      );
+
+    if (
+        hitOffset >= 0
+     && step + hitOffset < spanEnd && step + hitOffset <= line.Length()
+    ) {
+      intersectionResults =
+        ::TileResults(tile, glm::i32vec2(line.Texel(step + hitOffset)));
+      break;
+    }
+
+    // nothing on this span, the distance field might still skip further
+    int32_t const distance = ::CalculateSdfDistance(tile, texelOrigin);
+    step =
+      glm::max(
+        spanEnd
+      , step + ::SdfSkipDistance(distance, texelOrigin, rayDirection)
+      );
+  }
+}
+
+void RenderRayQuery(
+  pul::physics::IntersectorRay const & ray
+, pul::physics::IntersectionResults const & intersectionResults
+) {
+  if (!::showPhysicsQueries) { return; }
+
+  plugin::debug::RenderLine(
+    ray.beginOrigin, ray.endOrigin,
+    intersectionResults.collision
+  ? glm::vec4(1.0f, 0.2f, 0.2f, 1.0f) : glm::vec4(0.2f, 1.0f, 0.2f, 1.0f)
+  );
+}
+
+// fills the summed-area table over the solid texel counts of the chunk tiles;
+// the tile orientation doesn't change the count
+void BuildSolidTileSums(
+  pul::physics::TilemapLayer const & layer
+, pul::physics::TilemapLayer::Chunk & chunk
+) {
+  using Layer = pul::physics::TilemapLayer;
+
+  size_t constexpr
+    chunkTiles = static_cast<size_t>(Layer::chunkTiles)
+  , stride = chunkTiles + 1ul
+  ;
+
+  chunk.solidTileSums.fill(0u);
+
+  for (size_t y = 0ul; y < chunkTiles; ++ y) {
+    uint32_t rowSum = 0u;
+    for (size_t x = 0ul; x < chunkTiles; ++ x) {
+      auto const & tileInfo = chunk.tileInfo[y*chunkTiles + x];
+      if (tileInfo.Valid()) {
+        auto const & physicsTile =
+          layer.tilesets[tileInfo.TilesetIdx()]->tiles[tileInfo.ImageTileIdx()];
+        for (auto const mask : physicsTile.rowMasks)
+          { rowSum += static_cast<uint32_t>(std::popcount(mask)); }
+      }
+
+      chunk.solidTileSums[(y+1ul)*stride + x+1ul] =
+        chunk.solidTileSums[y*stride + x+1ul] + rowSum;
+    }
+  }
+}
+
+// fills the occupancy pyramid of a chunk, from tile cells up to a single cell
+// covering the entire chunk
+void BuildOccupancyPyramid(
+  pul::physics::TilemapLayer const & layer
+, pul::physics::TilemapLayer::Chunk & chunk
+) {
+  using Hint = pul::physics::TileIntersectAccelerationHint;
+  using Layer = pul::physics::TilemapLayer;
+
+  chunk.occupancyPyramid.clear();
+
+  { // -- tile level
+    Layer::Chunk::OccupancyLevel level;
+    level.solid.resize(chunk.tileInfo.size());
+    level.empty.resize(chunk.tileInfo.size());
+
+    for (size_t tileIdx = 0ul; tileIdx < chunk.tileInfo.size(); ++ tileIdx) {
+      auto const & tileInfo = chunk.tileInfo[tileIdx];
+      Hint hint = Hint::Empty;
+      if (tileInfo.Valid()) {
+        hint =
+          layer
+            .tilesets[tileInfo.TilesetIdx()]->tiles[tileInfo.ImageTileIdx()]
+            .accelerationHint;
+      }
+
+      level.solid[tileIdx] = hint != Hint::Empty;
+      level.empty[tileIdx] = hint != Hint::Full;
+    }
+
+    chunk.occupancyPyramid.emplace_back(std::move(level));
+  }
+
+  // -- coarser levels, each cell merges 2x2 cells of the previous level
+  for (
+    uint32_t fineWidth = static_cast<uint32_t>(Layer::chunkTiles);
+    fineWidth > 1u;
+    fineWidth /= 2u
+  ) {
+    auto const & fine = chunk.occupancyPyramid.back();
+    uint32_t const width = fineWidth/2u;
+
+    Layer::Chunk::OccupancyLevel level;
+    level.solid.resize(width*width, 0u);
+    level.empty.resize(width*width, 0u);
+
+    for (uint32_t y = 0u; y < fineWidth; ++ y)
+    for (uint32_t x = 0u; x < fineWidth; ++ x) {
+      size_t const
+        fineIdx = y*fineWidth + x
+      , coarseIdx = (y/2u)*width + x/2u
+      ;
+      level.solid[coarseIdx] |= fine.solid[fineIdx];
+      level.empty[coarseIdx] |= fine.empty[fineIdx];
+    }
+
+    chunk.occupancyPyramid.emplace_back(std::move(level));
+  }
+}
+
+// fills the seam normals of the chunk tiles from the solid texels of the tiles
+// around them, must be rebuilt whenever a neighbouring chunk is (un)loaded
+void BuildSeamNormals(
+  pul::physics::TilemapLayer const & layer
+, pul::physics::TilemapLayer::Chunk & chunk
+) {
+  using Layer = pul::physics::TilemapLayer;
+
+  int32_t constexpr
+    radius = static_cast<int32_t>(pul::physics::Tile::normalRadius)
+  , tileSize = static_cast<int32_t>(pul::physics::Tile::gridSize)
+  , apronSize = tileSize + 2*radius
+  ;
+
+  chunk.seamNormalIdx.fill(-1u);
+  chunk.seamNormals.clear();
+
+  // the 3x3 tiles around each tile are shared by its rows
+  ::ResolvedTileCache tileCache;
+
+  for (int32_t chunkTileY = 0; chunkTileY < Layer::chunkTiles; ++ chunkTileY)
+  for (int32_t chunkTileX = 0; chunkTileX < Layer::chunkTiles; ++ chunkTileX) {
+    glm::i32vec2 const texelBegin =
+      (chunk.origin*Layer::chunkTiles + glm::i32vec2(chunkTileX, chunkTileY))
+    * tileSize;
+
+    // solid texels of the tile & an apron of radius texels around it; bit
+    // x+radius of row y+radius is the texel at texelBegin + (x, y)
+    std::array<uint64_t, apronSize> rows;
+    uint64_t constexpr fullRow = (1ul << apronSize) - 1ul;
+
+    ::ResolvedTile neighbour;
+    for (int32_t y = -radius; y < tileSize + radius; ++ y) {
+      uint64_t row = 0u;
+      for (int32_t tileX = -1; tileX <= 1; ++ tileX) {
+        glm::u32vec2 texelOrigin;
+        ::ResolveTile(
+          layer, neighbour, texelOrigin
+        , texelBegin + glm::i32vec2(tileX*tileSize, y), &tileCache
+        );
+
+        uint64_t const mask = ::SpanMask(neighbour, texelOrigin, true);
+        int32_t const shift = radius + tileX*tileSize;
+        row |= shift >= 0 ? mask << shift : mask >> -shift;
+      }
+
+      rows[y+radius] = row & fullRow;
+    }
+
+    // uniformly solid or empty, every normal is zero either way
+    if (
+        std::all_of(
+          rows.begin(), rows.end(), [](uint64_t r) { return r == 0ul; }
+        )
+     || std::all_of(
+          rows.begin(), rows.end(), [](uint64_t r) { return r == fullRow; }
+        )
+    ) {
+      continue;
+    }
+
+    ::ResolvedTile tile;
+    glm::u32vec2 texelOrigin;
+    ::ResolveTile(layer, tile, texelOrigin, texelBegin, &tileCache);
+
+    std::array<
+      std::array<int8_t, 2>, Layer::Chunk::seamTexels
+    > normals;
+
+    bool seam = false;
+    for (int32_t y = 0; y < tileSize; ++ y)
+    for (int32_t x = 0; x < tileSize; ++ x) {
+      auto const texel = glm::u32vec2(x, y);
+      size_t const seamIdx = ::SeamTexelIdx(texel);
+      if (seamIdx == -1ul) { continue; }
+
+      normals[seamIdx] =
+        ::QuantizeNormal(
+          ::NeighbourhoodNormal([&](int32_t const ox, int32_t const oy) {
+            return (rows[y+radius+oy] >> (x+radius+ox)) & 1ul;
+          })
+        );
+
+      seam = seam || normals[seamIdx] != ::TileSpaceNormal(tile, texel);
+    }
+
+    if (!seam) { continue; }
+
+    chunk.seamNormalIdx[chunkTileY*Layer::chunkTiles + chunkTileX] =
+      static_cast<uint32_t>(chunk.seamNormals.size());
+    chunk.seamNormals.emplace_back(normals);
+  }
+}
+
+// amount of solid texels in the inclusive texel range, texels of chunks that
+// aren't loaded are empty. Tiles covered entirely by the range are counted
+// from the tile sums, the partially covered tiles at its border from their
+// row masks. If solidTexel is given & the count isn't zero, it's set to one of
+// the solid texels; the lowest of those at the border tiles and in the first
+// solid tile covered entirely, which the tile sums locate in constant time
+uint32_t SolidTexelCount(
+  pul::physics::TilemapLayer const & layer
+, glm::i32vec2 const texelMin, glm::i32vec2 const texelMax
+, glm::i32vec2 * const solidTexel = nullptr
+) {
+  using Hint = pul::physics::TileIntersectAccelerationHint;
+  using Layer = pul::physics::TilemapLayer;
+
+  int32_t constexpr
+    tileSize = static_cast<int32_t>(pul::physics::Tile::gridSize)
+  , chunkTexels = Layer::chunkTexels
+  , stride = Layer::chunkTiles + 1
+  ;
+
+  if (texelMin.x > texelMax.x || texelMin.y > texelMax.y) { return 0u; }
+
+  glm::i32vec2 const
+    chunkMin = ::FloorDiv(texelMin, chunkTexels)
+  , chunkMax = ::FloorDiv(texelMax, chunkTexels)
+  ;
+
+  // keeps the lowest row, then the lowest column
+  bool found = false;
+  auto const witness = [&solidTexel, &found](glm::i32vec2 const texel) {
+    if (!solidTexel) { return; }
+    if (
+        !found
+     || texel.y < solidTexel->y
+     || (texel.y == solidTexel->y && texel.x < solidTexel->x)
+    ) {
+      *solidTexel = texel;
+      found = true;
+    }
+  };
+
+  // first solid texel of the tile rows in the range, which must have one
+  auto const firstSolid =
+    [](
+      ::ResolvedTile const & tile, int32_t const rowMin, int32_t const rowMax
+    , uint32_t const columns
+    ) {
+      for (int32_t y = rowMin; y <= rowMax; ++ y) {
+        uint32_t const mask =
+            ::SpanMask(tile, glm::u32vec2(0u, static_cast<uint32_t>(y)), true)
+          & columns
+        ;
+        if (mask) { return glm::i32vec2(std::countr_zero(mask), y); }
+      }
+      return glm::i32vec2(0);
+    };
+
+  uint32_t count = 0u;
+  ::ResolvedTile tile;
+  for (int32_t chunkY = chunkMin.y; chunkY <= chunkMax.y; ++ chunkY)
+  for (int32_t chunkX = chunkMin.x; chunkX <= chunkMax.x; ++ chunkX) {
+    auto const chunk = layer.FindChunk(glm::i32vec2(chunkX, chunkY));
+    if (!chunk) { continue; }
+
+    // range within the chunk, and the tiles it touches & covers entirely
+    glm::i32vec2 const
+      chunkBegin = glm::i32vec2(chunkX, chunkY)*chunkTexels
+    , rangeMin = glm::max(texelMin - chunkBegin, glm::i32vec2(0))
+    , rangeMax =
+        glm::min(texelMax - chunkBegin, glm::i32vec2(chunkTexels - 1))
+    , tileMin = rangeMin / tileSize
+    , tileMax = rangeMax / tileSize
+    , innerMin = (rangeMin + tileSize - 1) / tileSize
+    , innerMax = (rangeMax + 1) / tileSize - 1
+    ;
+
+    bool const hasInner = innerMin.x <= innerMax.x && innerMin.y <= innerMax.y;
+
+    if (hasInner) {
+      auto const sum = [chunk](int32_t const x, int32_t const y) {
+        return chunk->solidTileSums[static_cast<size_t>(y*stride + x)];
+      };
+
+      // solid texels of the inclusive tile range
+      auto const rangeSum =
+        [&sum](glm::i32vec2 const lo, glm::i32vec2 const hi) {
+          return
+              sum(hi.x+1, hi.y+1) - sum(lo.x, hi.y+1)
+            - sum(hi.x+1, lo.y)   + sum(lo.x, lo.y)
+          ;
+        };
+
+      uint32_t const innerCount = rangeSum(innerMin, innerMax);
+      count += innerCount;
+
+      if (solidTexel && innerCount > 0u) {
+        // binary search the first tile row, and then the first tile of that
+        // row, with a solid texel
+        glm::i32vec2 lo = innerMin, hi = innerMax;
+        while (lo.y < hi.y) {
+          int32_t const mid = lo.y + (hi.y - lo.y)/2;
+          if (rangeSum(innerMin, glm::i32vec2(innerMax.x, mid)) > 0u)
+            { hi.y = mid; }
+          else
+            { lo.y = mid+1; }
+        }
+
+        while (lo.x < hi.x) {
+          int32_t const mid = lo.x + (hi.x - lo.x)/2;
+          if (
+            rangeSum(glm::i32vec2(innerMin.x, lo.y), glm::i32vec2(mid, lo.y))
+          > 0u
+          ) {
+            hi.x = mid;
+          } else {
+            lo.x = mid+1;
+          }
+        }
+
+        glm::i32vec2 const tileBegin = chunkBegin + lo*tileSize;
+        glm::u32vec2 texelOrigin;
+        ::ResolveTile(layer, tile, texelOrigin, tileBegin);
+        witness(tileBegin + firstSolid(tile, 0, tileSize - 1, ~0u));
+      }
+    }
+
+    for (int32_t tileY = tileMin.y; tileY <= tileMax.y; ++ tileY)
+    for (int32_t tileX = tileMin.x; tileX <= tileMax.x; ++ tileX) {
+      if (
+          hasInner
+       && tileX >= innerMin.x && tileX <= innerMax.x
+       && tileY >= innerMin.y && tileY <= innerMax.y
+      ) {
+        continue;
+      }
+
+      // part of the tile within the range, in texels of the tile
+      glm::i32vec2 const
+        tileBegin = glm::i32vec2(tileX, tileY)*tileSize
+      , partMin = glm::max(rangeMin - tileBegin, glm::i32vec2(0))
+      , partMax = glm::min(rangeMax - tileBegin, glm::i32vec2(tileSize - 1))
+      ;
+
+      glm::u32vec2 texelOrigin;
+      ::ResolveTile(layer, tile, texelOrigin, chunkBegin + tileBegin);
+
+      Hint const hint = ::TileAccelerationHint(tile);
+      if (hint == Hint::Empty) { continue; }
+      if (hint == Hint::Full) {
+        count +=
+          static_cast<uint32_t>(
+            (partMax.x - partMin.x + 1) * (partMax.y - partMin.y + 1)
+          );
+        witness(chunkBegin + tileBegin + partMin);
+        continue;
+      }
 
-  if (tileOrientation & Idx(pul::core::TileOrientation::FlipHorizontal))
-    { texel.x = 31 - texel.x; }
+      uint32_t const columns =
+          (~0u << static_cast<uint32_t>(partMin.x))
+        & (~0u >> static_cast<uint32_t>(tileSize - 1 - partMax.x))
+      ;
 
-  if (tileOrientation & Idx(pul::core::TileOrientation::FlipVertical))
-    { texel.y = 31 - texel.y; }
+      uint32_t const countBefore = count;
+      for (int32_t y = partMin.y; y <= partMax.y; ++ y) {
+        uint32_t const mask =
+          ::SpanMask(tile, glm::u32vec2(0u, static_cast<uint32_t>(y)), true);
+        count += static_cast<uint32_t>(std::popcount(mask & columns));
+      }
 
-  if (tileOrientation & Idx(pul::core::TileOrientation::FlipDiagonal)) {
-    std::swap(texel.x, texel.y);
+      if (solidTexel && count > countBefore) {
+        witness(
+          chunkBegin + tileBegin
+        + firstSolid(tile, partMin.y, partMax.y, columns)
+        );
+      }
+    }
   }
 
-  // -- compute intersection SDF and accel hints
-  return physicsTile.signedDistanceField[texel.x][texel.y];
+  return count;
 }
 
 glm::vec2 GetAabbMin(glm::vec2 const & aabbOrigin, glm::vec2 const & aabbDim) {
@@ -164,27 +1047,50 @@ glm::vec2 GetAabbMax(glm::vec2 const & aabbOrigin, glm::vec2 const & aabbDim) {
   return glm::max(p0, p1);
 }
 
-bool IntersectionRayAabb(
-  glm::vec2 const & rayBegin, glm::vec2 const & rayEnd
-, glm::vec2 const & aabbOrigin, glm::vec2 const & aabbDim
-, float & intersectionLength
+// earliest time in 0 .. 1 at which the moving box enters the texel, and the
+// axis it enters through. Texels the box already overlaps are not entered
+bool IntersectionSweptAabbTexel(
+  glm::vec2 const & boxMin, glm::vec2 const & boxMax
+, glm::vec2 const & velocity
+, glm::vec2 const & texelMin
+, float & timeOfImpact, size_t & axis
 ) {
-  glm::vec2 normal = glm::normalize(rayEnd - rayBegin);
-  normal.x = normal.x == 0.0f ? 1.0f : 1.0f / normal.x;
-  normal.y = normal.y == 0.0f ? 1.0f : 1.0f / normal.y;
+  // the box is shrunk by a small skin so that a box resting exactly against a
+  // texel, up to float precision, still collides with it instead of being
+  // considered inside of it
+  float constexpr skin = 0.01f;
+
+  float timeEnter = -std::numeric_limits<float>::infinity();
+  float timeExit  = +std::numeric_limits<float>::infinity();
+
+  // y first so that corners resolve to the y axis
+  for (size_t const it : { 1ul, 0ul }) {
+    float const
+      boxAxisMin = boxMin[it] + skin
+    , boxAxisMax = boxMax[it] - skin
+    , texelAxisMin = texelMin[it]
+    , texelAxisMax = texelMin[it] + 1.0f
+    ;
+
+    if (velocity[it] == 0.0f) {
+      if (boxAxisMax <= texelAxisMin || boxAxisMin >= texelAxisMax)
+        { return false; }
+      continue;
+    }
 
-  glm::vec2 const min = (GetAabbMin(aabbOrigin, aabbDim) - rayBegin) * normal;
-  glm::vec2 const max = (GetAabbMax(aabbOrigin, aabbDim) - rayBegin) * normal;
+    float t0 = (texelAxisMin - boxAxisMax) / velocity[it];
+    float t1 = (texelAxisMax - boxAxisMin) / velocity[it];
+    if (t0 > t1) { std::swap(t0, t1); }
 
-  float tmin = glm::max(glm::min(min.x, max.x), glm::min(min.y, max.y));
-  float tmax = glm::min(glm::max(min.x, max.x), glm::max(min.y, max.y));
+    if (t0 > timeEnter) { timeEnter = t0; axis = it; }
+    timeExit = glm::min(timeExit, t1);
+  }
 
-  if (tmax < 0.0f || tmin > tmax)
+  if (timeEnter >= timeExit || timeEnter < 0.0f || timeEnter > 1.0f)
     { return false; }
 
-  float t = tmin < 0.0f ? tmax : tmin;
-  intersectionLength = t;
-  return t > 0.0f && t < glm::length(rayEnd - rayBegin);
+  timeOfImpact = timeEnter;
+  return true;
 }
 
 bool IntersectionCircleAabb(
@@ -199,58 +1105,860 @@ bool IntersectionCircleAabb(
     , GetAabbMax(aabbOrigin, aabbDim)
     );
 
-  return glm::length(circleOrigin - closestOrigin) <= circleRadius;
-}
+  return glm::length(circleOrigin - closestOrigin) <= circleRadius;
+}
+
+// earliest time in 0 .. 1 at which the segment enters the box (slab test), and
+// the normal of the face it enters through. Segments that begin inside of the
+// box hit at time 0, facing against the direction of the segment
+bool IntersectionSegmentAabb(
+  glm::vec2 const & begin, glm::vec2 const & delta
+, glm::vec2 const & boxMin, glm::vec2 const & boxMax
+, float & timeOfImpact, glm::vec2 & normal
+) {
+  float timeEnter = 0.0f, timeExit = 1.0f;
+  normal =
+    delta == glm::vec2(0.0f) ? glm::vec2(0.0f) : -glm::normalize(delta);
+
+  for (size_t it = 0ul; it < 2ul; ++ it) {
+    if (delta[it] == 0.0f) {
+      if (begin[it] < boxMin[it] || begin[it] > boxMax[it])
+        { return false; }
+      continue;
+    }
+
+    float t0 = (boxMin[it] - begin[it]) / delta[it];
+    float t1 = (boxMax[it] - begin[it]) / delta[it];
+    if (t0 > t1) { std::swap(t0, t1); }
+
+    if (t0 > timeEnter) {
+      timeEnter = t0;
+      normal = glm::vec2(0.0f);
+      normal[it] = -glm::sign(delta[it]);
+    }
+
+    timeExit = glm::min(timeExit, t1);
+
+    if (timeEnter > timeExit) { return false; }
+  }
+
+  timeOfImpact = timeEnter;
+  return true;
+}
+
+// uniform grid of entity hitboxes, rebuilt once per logic tick. Grid cells are
+// hashed into a fixed amount of buckets whose contents are stored contiguously
+// (counting sort), so once the buffers have grown a rebuild doesn't allocate.
+// Buckets only narrow down the candidates, hitboxes are always tested against
+// their current origin. Read-only between rebuilds, so queries can run
+// concurrently
+struct EntityBroadphase {
+  static int32_t constexpr cellSize = 128;
+  static uint32_t constexpr bucketCount = 1024u;
+
+  // entities still move during the tick after the rebuild, so hitboxes are
+  // registered with a margin that covers a tick worth of movement. It's
+  // estimated from how far the entity moved since the previous rebuild,
+  // doubled to leave room for acceleration
+  static float constexpr minMargin = 32.0f;
+
+  // anything that moved further than this was teleported (spawned, respawned)
+  // rather than moving, which doesn't predict its next tick
+  static float constexpr maxMargin = 512.0f;
+
+  std::vector<entt::entity> entries;
+  std::vector<float> margins; // per entry
+
+  // origin & margin of every entry as of the previous rebuild, sorted by
+  // entity so the next rebuild can look them up
+  struct Registration {
+    entt::entity entity;
+    glm::vec2 origin;
+    float margin;
+  };
+  std::vector<Registration> registrations;
+
+  // entities that moved past the margin they were registered with since the
+  // previous rebuild, queries during that tick could have missed them. Only
+  // shown in the debug UI
+  size_t marginOverruns = 0ul;
+
+  std::array<uint32_t, bucketCount+1> bucketStart;
+  std::vector<uint32_t> bucketEntries;
+
+  // structure-of-arrays mirror of the entry hitbox bounds (plus margin) for
+  // the ray kernel, which gathers the candidates it tests in batches of
+  // rayKernelWidth
+  static size_t constexpr rayKernelWidth = 8ul;
+  std::vector<float> boundsMinX, boundsMinY, boundsMaxX, boundsMaxY;
+};
+
+bool useEntityBroadphase = true;
+EntityBroadphase entityBroadphase;
+
+uint32_t BroadphaseBucket(glm::i32vec2 const cell) {
+  uint32_t const hash =
+      (static_cast<uint32_t>(cell.x) * 73856093u)
+    ^ (static_cast<uint32_t>(cell.y) * 19349663u)
+  ;
+  return hash % EntityBroadphase::bucketCount;
+}
+
+// iterates the buckets of every cell the hitbox (plus margin) overlaps
+template <typename Fn>
+void ForEachHitboxBucket(
+  pul::util::ComponentHitboxAABB const & hitbox
+, pul::util::ComponentOrigin const & origin
+, float const margin
+, Fn && fn
+) {
+  auto const center = origin.origin + glm::vec2(hitbox.offset);
+  auto const dimensions = glm::vec2(hitbox.dimensions);
+
+  auto const cellMin =
+    glm::i32vec2(
+      glm::floor(
+        (GetAabbMin(center, dimensions) - margin)
+      / static_cast<float>(EntityBroadphase::cellSize)
+      )
+    );
+
+  auto const cellMax =
+    glm::i32vec2(
+      glm::floor(
+        (GetAabbMax(center, dimensions) + margin)
+      / static_cast<float>(EntityBroadphase::cellSize)
+      )
+    );
+
+  for (int32_t y = cellMin.y; y <= cellMax.y; ++ y)
+  for (int32_t x = cellMin.x; x <= cellMax.x; ++ x)
+    { fn(::BroadphaseBucket(glm::i32vec2(x, y))); }
+}
+
+void GatherBucketEntities(uint32_t const bucket) {
+  auto const & broadphase = ::entityBroadphase;
+  auto & candidates = ::LocalQueryScratch().broadphaseCandidates;
+  candidates.insert(
+    candidates.end()
+  , broadphase.bucketEntries.begin() + broadphase.bucketStart[bucket]
+  , broadphase.bucketEntries.begin() + broadphase.bucketStart[bucket+1]
+  );
+}
+
+// sorts & deduplicates the gathered candidates, entities spanning several
+// cells show up once per cell
+void DeduplicateCandidates() {
+  auto & candidates = ::LocalQueryScratch().broadphaseCandidates;
+  std::sort(candidates.begin(), candidates.end());
+  candidates.erase(
+    std::unique(candidates.begin(), candidates.end()), candidates.end()
+  );
+}
+
+// gathers the buckets of every grid cell the segment passes through, walking
+// its line a cell at a time. The line is off from the segment by less than a
+// texel, which the hitbox margins cover
+void GatherSegmentBuckets(glm::vec2 const & begin, glm::vec2 const & delta) {
+  auto const line =
+    pul::physics::BresenhamLineParametric::Construct(
+      glm::i32vec2(glm::round(begin)), glm::i32vec2(glm::round(begin + delta))
+    );
+
+  for (
+    int64_t step = 0;
+    step <= line.Length();
+    step = line.NextCellStep(step, EntityBroadphase::cellSize)
+  ) {
+    auto const cell =
+      ::FloorDiv(glm::i32vec2(line.Texel(step)), EntityBroadphase::cellSize);
+    ::GatherBucketEntities(::BroadphaseBucket(cell));
+  }
+}
+
+// slab test of one segment against the mirrored hitboxes of the deduplicated
+// candidates, four boxes per SSE instruction, then the hits sorted by entry
+// time into rayKernelHits
+void RayKernel(glm::vec2 const & begin, glm::vec2 const & delta) {
+  auto const & broadphase = ::entityBroadphase;
+  auto & scratch = ::LocalQueryScratch();
+  auto const & candidates = scratch.broadphaseCandidates;
+
+  auto & hits = scratch.rayKernelHits;
+  hits.clear();
+
+  // gather the candidate bounds contiguously, padding boxes are never
+  // reported so their contents don't matter
+  size_t const boxCount =
+    (
+      (candidates.size() + EntityBroadphase::rayKernelWidth - 1ul)
+    / EntityBroadphase::rayKernelWidth
+    ) * EntityBroadphase::rayKernelWidth
+  ;
+
+  scratch.rayBoundsMinX.resize(boxCount);
+  scratch.rayBoundsMinY.resize(boxCount);
+  scratch.rayBoundsMaxX.resize(boxCount);
+  scratch.rayBoundsMaxY.resize(boxCount);
+  scratch.rayEntryTimes.resize(boxCount);
+
+  for (size_t it = 0ul; it < candidates.size(); ++ it) {
+    uint32_t const entryIdx = candidates[it];
+    scratch.rayBoundsMinX[it] = broadphase.boundsMinX[entryIdx];
+    scratch.rayBoundsMinY[it] = broadphase.boundsMinY[entryIdx];
+    scratch.rayBoundsMaxX[it] = broadphase.boundsMaxX[entryIdx];
+    scratch.rayBoundsMaxY[it] = broadphase.boundsMaxY[entryIdx];
+  }
+
+  // a large finite value rather than infinity for axis aligned segments, so a
+  // box edge lying on the segment doesn't produce 0 * inf = NaN
+  auto const inverse = [](float const d) {
+    return d == 0.0f ? 1e30f : 1.0f / d;
+  };
+
+  float const inverseX = inverse(delta.x), inverseY = inverse(delta.y);
+
+  float const * const minX = scratch.rayBoundsMinX.data();
+  float const * const minY = scratch.rayBoundsMinY.data();
+  float const * const maxX = scratch.rayBoundsMaxX.data();
+  float const * const maxY = scratch.rayBoundsMaxY.data();
+  float * const entryTimes = scratch.rayEntryTimes.data();
+
+  #if defined(__SSE2__)
+    __m128 const
+      beginX = _mm_set1_ps(begin.x), beginY = _mm_set1_ps(begin.y)
+    , invX = _mm_set1_ps(inverseX), invY = _mm_set1_ps(inverseY)
+    , zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f)
+    , miss = _mm_set1_ps(std::numeric_limits<float>::infinity())
+    ;
+
+    for (size_t it = 0ul; it < boxCount; it += 4ul) {
+      __m128 const
+        tx0 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(minX + it), beginX), invX)
+      , tx1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(maxX + it), beginX), invX)
+      , ty0 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(minY + it), beginY), invY)
+      , ty1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(maxY + it), beginY), invY)
+      ;
+
+      __m128 const
+        enter =
+          _mm_max_ps(
+            _mm_max_ps(_mm_min_ps(tx0, tx1), _mm_min_ps(ty0, ty1)), zero
+          )
+      , exit =
+          _mm_min_ps(
+            _mm_min_ps(_mm_max_ps(tx0, tx1), _mm_max_ps(ty0, ty1)), one
+          )
+      , hit = _mm_cmple_ps(enter, exit)
+      ;
+
+      _mm_storeu_ps(
+        entryTimes + it
+      , _mm_or_ps(_mm_and_ps(hit, enter), _mm_andnot_ps(hit, miss))
+      );
+    }
+  #else
+    for (size_t it = 0ul; it < boxCount; ++ it) {
+      float const
+        tx0 = (minX[it] - begin.x) * inverseX
+      , tx1 = (maxX[it] - begin.x) * inverseX
+      , ty0 = (minY[it] - begin.y) * inverseY
+      , ty1 = (maxY[it] - begin.y) * inverseY
+      ;
+
+      float const
+        enter =
+          glm::max(
+            glm::max(glm::min(tx0, tx1), glm::min(ty0, ty1)), 0.0f
+          )
+      , exit =
+          glm::min(
+            glm::min(glm::max(tx0, tx1), glm::max(ty0, ty1)), 1.0f
+          )
+      ;
+
+      entryTimes[it] =
+        enter <= exit ? enter : std::numeric_limits<float>::infinity();
+    }
+  #endif
+
+  for (size_t it = 0ul; it < candidates.size(); ++ it) {
+    if (entryTimes[it] <= 1.0f)
+      { hits.emplace_back(entryTimes[it], candidates[it]); }
+  }
+
+  std::sort(hits.begin(), hits.end());
+}
+
+template <typename Fn>
+void ForEachCandidateEntity(Fn && fn) {
+  ::DeduplicateCandidates();
+
+  for (auto const entryIdx : ::LocalQueryScratch().broadphaseCandidates)
+    { fn(::entityBroadphase.entries[entryIdx]); }
+}
+
+// merges the chunk tiles containing solid texels into as few rectangles as
+// possible (greedy, rows first) and attaches them as fixtures of a single
+// static body, rather than creating a body per tile
+b2Body * BuildStaticGeometry(
+  pul::physics::TilemapLayer const & layer
+, pul::physics::TilemapLayer::Chunk const & chunk
+) {
+  size_t constexpr width = pul::physics::TilemapLayer::chunkTiles;
+
+  std::vector<bool> occupied(width*width, false);
+  for (size_t tileIdx = 0ul; tileIdx < occupied.size(); ++ tileIdx) {
+    auto const & tileInfo = chunk.tileInfo[tileIdx];
+    if (!tileInfo.Valid()) { continue; }
+
+    auto const & physicsTile =
+      layer.tilesets[tileInfo.TilesetIdx()]->tiles[tileInfo.ImageTileIdx()];
+
+    occupied[tileIdx] =
+      physicsTile.accelerationHint
+   != pul::physics::TileIntersectAccelerationHint::Empty
+    ;
+  }
+
+  if (std::none_of(occupied.begin(), occupied.end(), [](bool v) { return v; }))
+    { return nullptr; }
+
+  glm::vec2 const chunkTileBegin =
+    glm::vec2(chunk.origin*static_cast<int32_t>(width));
+
+  b2BodyDef bodyDef;
+  b2Body * body = ::boxWorld->CreateBody(&bodyDef);
+
+  size_t boxCount = 0ul;
+  for (size_t y = 0ul; y < width; ++ y)
+  for (size_t x = 0ul; x < width; ++ x) {
+    if (!occupied[y*width + x]) { continue; }
+
+    // grow along the row, then grow downwards while the whole row is free
+    size_t boxWidth = 1ul;
+    while (x+boxWidth < width && occupied[y*width + x+boxWidth])
+      { ++ boxWidth; }
+
+    size_t boxHeight = 1ul;
+    for (; y+boxHeight < width; ++ boxHeight) {
+      auto const rowBegin = occupied.begin() + (y+boxHeight)*width + x;
+      if (!std::all_of(rowBegin, rowBegin + boxWidth, [](bool v) { return v; }))
+        { break; }
+    }
+
+    for (size_t by = y; by < y+boxHeight; ++ by)
+    for (size_t bx = x; bx < x+boxWidth;  ++ bx)
+      { occupied[by*width + bx] = false; }
+
+    float const tileMeters = 32.0f*Consts::pixelsToMeters;
+    glm::vec2 const center =
+      chunkTileBegin + glm::vec2(x + boxWidth*0.5f, y + boxHeight*0.5f);
+
+    b2PolygonShape box;
+    box.SetAsBox(
+      boxWidth*0.5f*tileMeters, boxHeight*0.5f*tileMeters
+    , b2Vec2(center.x*tileMeters, center.y*tileMeters)
+    , 0.0f
+    );
+    body->CreateFixture(&box, 0.0f);
+    ++ boxCount;
+  }
+
+  spdlog::debug(
+    "merged static geometry of chunk {}x{} to {} boxes"
+  , chunk.origin.x, chunk.origin.y, boxCount
+  );
+
+  return body;
+}
+
+// static body of every loaded chunk that has geometry, keyed by GridKey
+std::unordered_map<uint64_t, b2Body *> chunkStaticBodies;
+
+// builds the acceleration structures & static geometry of a chunk once its
+// tiles are filled in, except for the seam normals
+void FinalizeChunk(
+  pul::physics::TilemapLayer const & layer
+, pul::physics::TilemapLayer::Chunk & chunk
+) {
+  ::BuildSolidTileSums(layer, chunk);
+  ::BuildOccupancyPyramid(layer, chunk);
+
+  // see BuildSeamNormals, which needs the neighbouring chunks
+  chunk.seamNormalIdx.fill(-1u);
+  chunk.seamNormals.clear();
+
+  if (!::boxWorld) { return; }
+  if (b2Body * body = ::BuildStaticGeometry(layer, chunk); body) {
+    ::chunkStaticBodies[pul::physics::TilemapLayer::GridKey(chunk.origin)] =
+      body;
+  }
+}
+
+// the border tiles of the chunks around a chunk see its tiles, so their seam
+// normals are rebuilt along with its own whenever it's (un)loaded
+void BuildNeighbourhoodSeamNormals(
+  pul::physics::TilemapLayer & layer
+, glm::i32vec2 const chunkOrigin
+) {
+  using Layer = pul::physics::TilemapLayer;
+
+  for (int32_t y = -1; y <= 1; ++ y)
+  for (int32_t x = -1; x <= 1; ++ x) {
+    auto chunk =
+      layer.chunks.find(Layer::GridKey(chunkOrigin + glm::i32vec2(x, y)));
+    if (chunk != layer.chunks.end())
+      { ::BuildSeamNormals(layer, chunk->second); }
+  }
+}
+
+void EraseChunk(glm::i32vec2 const chunkOrigin) {
+  auto const key = pul::physics::TilemapLayer::GridKey(chunkOrigin);
+
+  ::physicsWorld.tilemapLayer.chunks.erase(key);
+
+  if (auto body = ::chunkStaticBodies.find(key);
+      body != ::chunkStaticBodies.end()
+  ) {
+    if (::boxWorld) { ::boxWorld->DestroyBody(body->second); }
+    ::chunkStaticBodies.erase(body);
+  }
+}
+
+// the tile fields in the order they're cached, each is written as-is
+template <typename Fn>
+constexpr void ForEachCachedTileField(pul::physics::Tile & tile, Fn && fn) {
+  fn(tile.rowMasks);
+  fn(tile.columnMasks);
+  fn(tile.signedDistanceField);
+  fn(tile.surfaceNormals);
+  fn(tile.accelerationHint);
+}
+
+size_t constexpr CachedTileByteSize() {
+  size_t byteSize = 0ul;
+  pul::physics::Tile tile {};
+  ::ForEachCachedTileField(
+    tile, [&byteSize](auto const & field) { byteSize += sizeof(field); }
+  );
+  return byteSize;
+}
+
+// processed tilesets are cached on disk as this header followed by the tiles,
+// field by field so that no padding ends up in the file. A cache written with
+// a different field layout is rejected through tileByteSize, bump the version
+// for layout changes that keep the size
+struct TilesetCacheHeader {
+  std::array<char, 4> magic = {'P', 'U', 'L', 'T'};
+  uint32_t version = 2u;
+  uint64_t fileHash = 0ul;
+  uint64_t tileCount = 0ul;
+  uint64_t tileByteSize = ::CachedTileByteSize();
+
+  bool operator==(TilesetCacheHeader const &) const = default;
+};
+
+static_assert(
+  std::has_unique_object_representations_v<TilesetCacheHeader>
+, "the cache header is written as raw bytes"
+);
+
+// hash of the bytes of the image file, false if it can't be read. The bytes
+// are mixed in a word at a time, the length keeps trailing zeroes apart
+bool FileHash(std::string const & filename, uint64_t & hash) {
+  auto file = std::ifstream{filename, std::ios::binary | std::ios::ate};
+  if (!file.good()) { return false; }
+
+  size_t const byteLength = static_cast<size_t>(file.tellg());
+  std::vector<uint64_t> words((byteLength + 7ul) / 8ul, 0ul);
+  file.seekg(0);
+  if (!file.read(reinterpret_cast<char *>(words.data()), byteLength))
+    { return false; }
+
+  hash = 14695981039346656037ul ^ byteLength;
+  for (uint64_t const word : words) {
+    hash ^= word;
+    hash *= 1099511628211ul;
+    hash ^= hash >> 29ul;
+  }
+  return true;
+}
+
+// tests the segment against the entity hitboxes, filling rayEntityHits with
+// every entity hit & its entry time, unordered. With damageableOnly entities
+// without a ComponentDamageable are skipped
+void GatherRayEntityHits(
+  entt::registry & registry
+, glm::vec2 const & begin, glm::vec2 const & delta
+, entt::entity const ignoredEntity
+, bool const damageableOnly
+) {
+  auto view =
+    registry.view<
+      pul::util::ComponentHitboxAABB
+    , pul::util::ComponentOrigin
+    >();
+
+  auto & hits = ::LocalQueryScratch().rayEntityHits;
+  hits.clear();
+
+  auto const testEntity = [&](entt::entity const entity) {
+    // entity could have been destroyed since the broadphase was built
+    if (
+        entity == ignoredEntity
+     || !registry.valid(entity)
+     || !registry.has<
+          pul::util::ComponentHitboxAABB, pul::util::ComponentOrigin
+        >(entity)
+     || (
+          damageableOnly
+       && !registry.has<pul::core::ComponentDamageable>(entity)
+        )
+    ) {
+      return;
+    }
+
+    auto const & hitbox = view.get<pul::util::ComponentHitboxAABB>(entity);
+    auto const & origin = view.get<pul::util::ComponentOrigin>(entity);
+
+    auto const center = origin.origin + glm::vec2(hitbox.offset);
+    auto const dimensions = glm::vec2(hitbox.dimensions);
+
+    float timeOfImpact;
+    glm::vec2 normal;
+    if (
+      ::IntersectionSegmentAabb(
+        begin, delta
+      , ::GetAabbMin(center, dimensions), ::GetAabbMax(center, dimensions)
+      , timeOfImpact, normal
+      )
+    ) {
+      hits.emplace_back(timeOfImpact, entity);
+    }
+  };
+
+  if (!::useEntityBroadphase) {
+    for (auto entity : view) { testEntity(entity); }
+    return;
+  }
+
+  // only the entities of the cells along the segment reach the kernel. The
+  // mirrored bounds include the margin, so they only narrow down the
+  // candidates further; hitboxes are tested against their current origin
+  ::LocalQueryScratch().broadphaseCandidates.clear();
+  ::GatherSegmentBuckets(begin, delta);
+  ::DeduplicateCandidates();
+  ::RayKernel(begin, delta);
+
+  for (auto const & [entryTime, entryIdx] : ::LocalQueryScratch().rayKernelHits)
+    { testEntity(::entityBroadphase.entries[entryIdx]); }
+}
+
+// tests the circle against the entity hitboxes, filling circleEntityHits with
+// every entity hit & the closest origin of its hitbox to the circle
+void GatherCircleEntityHits(
+  entt::registry & registry
+, pul::physics::IntersectorCircle const & circle
+) {
+  auto view =
+    registry.view<
+      pul::util::ComponentHitboxAABB
+    , pul::util::ComponentOrigin
+    >();
+
+  auto & hits = ::LocalQueryScratch().circleEntityHits;
+  hits.clear();
+
+  auto const testEntity = [&](entt::entity const entity) {
+    // entity could have been destroyed since the broadphase was built
+    if (
+        !registry.valid(entity)
+     || !registry.has<
+          pul::util::ComponentHitboxAABB, pul::util::ComponentOrigin
+        >(entity)
+    ) {
+      return;
+    }
+
+    auto const & hitbox = view.get<pul::util::ComponentHitboxAABB>(entity);
+    auto const & origin = view.get<pul::util::ComponentOrigin>(entity);
+
+    glm::vec2 closestOrigin;
+    bool intersection =
+      ::IntersectionCircleAabb(
+        glm::vec2(circle.origin), circle.radius
+      , origin.origin + glm::vec2(hitbox.offset)
+      , glm::vec2(hitbox.dimensions)
+      , closestOrigin
+      );
+
+    if (intersection)
+      { hits.emplace_back(glm::i32vec2(glm::round(closestOrigin)), entity); }
+  };
+
+  if (!::useEntityBroadphase) {
+    for (auto entity : view) { testEntity(entity); }
+    return;
+  }
+
+  // every cell overlapped by the circle's bounds
+  ::LocalQueryScratch().broadphaseCandidates.clear();
+
+  auto const cellMin =
+    glm::i32vec2(
+      glm::floor(
+        (glm::vec2(circle.origin) - circle.radius)
+      / static_cast<float>(EntityBroadphase::cellSize)
+      )
+    );
+
+  auto const cellMax =
+    glm::i32vec2(
+      glm::floor(
+        (glm::vec2(circle.origin) + circle.radius)
+      / static_cast<float>(EntityBroadphase::cellSize)
+      )
+    );
+
+  for (int32_t y = cellMin.y; y <= cellMax.y; ++ y)
+  for (int32_t x = cellMin.x; x <= cellMax.x; ++ x)
+    { ::GatherBucketEntities(::BroadphaseBucket(glm::i32vec2(x, y))); }
+
+  ::ForEachCandidateEntity(testEntity);
+}
+
+} // -- namespace
+
+// -- plugin functions
+void plugin::physics::UpdateEntityBroadphase(pul::core::SceneBundle & scene) {
+  auto & registry = scene.EnttRegistry();
+  auto & broadphase = ::entityBroadphase;
+
+  auto view =
+    registry.view<
+      pul::util::ComponentHitboxAABB
+    , pul::util::ComponentOrigin
+    >();
+
+  broadphase.entries.clear();
+  broadphase.margins.clear();
+  broadphase.bucketStart.fill(0u);
+  broadphase.marginOverruns = 0ul;
+
+  auto const registrationLess =
+    [](
+      EntityBroadphase::Registration const & registration
+    , entt::entity const entity
+    ) {
+      return registration.entity < entity;
+    };
+
+  // count bucket sizes, shifted by one so the prefix sum yields bucket starts
+  for (auto entity : view) {
+    auto const & origin = view.get<pul::util::ComponentOrigin>(entity);
+
+    float margin = EntityBroadphase::minMargin;
+
+    auto const registration =
+      std::lower_bound(
+        broadphase.registrations.begin(), broadphase.registrations.end()
+      , entity, registrationLess
+      );
+
+    if (
+        registration != broadphase.registrations.end()
+     && registration->entity == entity
+    ) {
+      float const displacement =
+        glm::length(origin.origin - registration->origin);
+
+      if (displacement <= EntityBroadphase::maxMargin) {
+        if (displacement > registration->margin)
+          { ++ broadphase.marginOverruns; }
+
+        margin =
+          glm::clamp(
+            displacement*2.0f
+          , EntityBroadphase::minMargin, EntityBroadphase::maxMargin
+          );
+      }
+    }
+
+    broadphase.entries.emplace_back(entity);
+    broadphase.margins.emplace_back(margin);
+    ::ForEachHitboxBucket(
+      view.get<pul::util::ComponentHitboxAABB>(entity), origin, margin
+    , [&](uint32_t const bucket) { ++ broadphase.bucketStart[bucket+1]; }
+    );
+  }
+
+  { // register the origins the next rebuild measures movement from
+    broadphase.registrations.clear();
+    for (
+      size_t entryIdx = 0ul; entryIdx < broadphase.entries.size(); ++ entryIdx
+    ) {
+      auto const entity = broadphase.entries[entryIdx];
+      broadphase.registrations.emplace_back(
+        EntityBroadphase::Registration {
+          .entity = entity
+        , .origin = view.get<pul::util::ComponentOrigin>(entity).origin
+        , .margin = broadphase.margins[entryIdx]
+        }
+      );
+    }
+
+    std::sort(
+      broadphase.registrations.begin(), broadphase.registrations.end()
+    , [](auto const & a, auto const & b) { return a.entity < b.entity; }
+    );
+  }
+
+  for (uint32_t bucket = 1u; bucket <= EntityBroadphase::bucketCount; ++ bucket)
+    { broadphase.bucketStart[bucket] += broadphase.bucketStart[bucket-1]; }
+
+  { // mirror the bounds
+    for (
+      auto * bounds
+    : { &broadphase.boundsMinX, &broadphase.boundsMinY
+      , &broadphase.boundsMaxX, &broadphase.boundsMaxY
+      }
+    ) {
+      bounds->resize(broadphase.entries.size());
+    }
+
+    for (
+      size_t entryIdx = 0ul; entryIdx < broadphase.entries.size(); ++ entryIdx
+    ) {
+      auto const entity = broadphase.entries[entryIdx];
+      auto const & hitbox = view.get<pul::util::ComponentHitboxAABB>(entity);
+      auto const & origin = view.get<pul::util::ComponentOrigin>(entity);
+
+      auto const center = origin.origin + glm::vec2(hitbox.offset);
+      auto const dimensions = glm::vec2(hitbox.dimensions);
+      float const margin = broadphase.margins[entryIdx];
+      auto const
+        min = ::GetAabbMin(center, dimensions) - margin
+      , max = ::GetAabbMax(center, dimensions) + margin
+      ;
+
+      broadphase.boundsMinX[entryIdx] = min.x;
+      broadphase.boundsMinY[entryIdx] = min.y;
+      broadphase.boundsMaxX[entryIdx] = max.x;
+      broadphase.boundsMaxY[entryIdx] = max.y;
+    }
+  }
+
+  broadphase.bucketEntries.resize(
+    broadphase.bucketStart[EntityBroadphase::bucketCount]
+  );
+
+  std::array<uint32_t, EntityBroadphase::bucketCount> bucketFill;
+  std::copy_n(
+    broadphase.bucketStart.begin(), bucketFill.size(), bucketFill.begin()
+  );
 
-} // -- namespace
+  for (
+    size_t entryIdx = 0ul; entryIdx < broadphase.entries.size(); ++ entryIdx
+  ) {
+    auto const entity = broadphase.entries[entryIdx];
+    ::ForEachHitboxBucket(
+      view.get<pul::util::ComponentHitboxAABB>(entity)
+    , view.get<pul::util::ComponentOrigin>(entity)
+    , broadphase.margins[entryIdx]
+    , [&](uint32_t const bucket) {
+        broadphase.bucketEntries[bucketFill[bucket]++] =
+          static_cast<uint32_t>(entryIdx);
+      }
+    );
+  }
+}
 
-// -- plugin functions
 void plugin::physics::EntityIntersectionRaycast(
   pul::core::SceneBundle & scene
 , pul::physics::IntersectorRay const & ray
 , pul::physics::EntityIntersectionResults & intersectionResults
 ) {
-  auto & registry = scene.EnttRegistry();
+  intersectionResults.entities.clear();
 
-  auto view =
-    registry.view<
-      pul::util::ComponentHitboxAABB
-    , pul::util::ComponentOrigin
-    >();
+  glm::vec2 const
+    rayOriginBegin = glm::vec2(ray.beginOrigin)
+  , rayDelta = glm::vec2(ray.endOrigin - ray.beginOrigin)
+  ;
 
-  intersectionResults.entities.clear();
+  ::GatherRayEntityHits(
+    scene.EnttRegistry(), rayOriginBegin, rayDelta, entt::null, false
+  );
+
+  // hits are reported ordered by entry time
+  auto & hits = ::LocalQueryScratch().rayEntityHits;
+  std::sort(hits.begin(), hits.end());
+
+  for (auto const & [timeOfImpact, entity] : hits) {
+    intersectionResults.collision = true;
+    intersectionResults.entities.emplace_back(
+      glm::i32vec2(glm::round(rayOriginBegin + rayDelta*timeOfImpact))
+    , entity
+    );
+  }
+}
+
+size_t plugin::physics::EntityIntersectionRaycastSorted(
+  pul::physics::PhysicsWorld const & world
+, pul::core::SceneBundle & scene
+, pul::physics::IntersectorEntityRay const & intersector
+, std::span<pul::physics::EntityRaycastHit> const hits
+, pul::physics::IntersectionResults & layerResults
+) {
+  layerResults = {};
+
+  auto ray = intersector.ray;
+
+  if (intersector.stopAtLayer) {
+    ::ResolvedTile tile;
+    ::TraceRay(world.tilemapLayer, ray, false, layerResults, tile);
+    ::RenderRayQuery(ray, layerResults);
+
+    if (layerResults.collision) { ray.endOrigin = layerResults.origin; }
+  }
+
+  if (hits.empty()) { return 0ul; }
 
   glm::vec2 const
     rayOriginBegin = glm::vec2(ray.beginOrigin)
-  , rayOriginEnd = glm::vec2(ray.endOrigin)
+  , rayDelta = glm::vec2(ray.endOrigin - ray.beginOrigin)
   ;
 
-  for (auto & entity : view) {
-    auto const & hitbox = view.get<pul::util::ComponentHitboxAABB>(entity);
-    auto const & origin = view.get<pul::util::ComponentOrigin>(entity);
+  ::GatherRayEntityHits(
+    scene.EnttRegistry(), rayOriginBegin, rayDelta
+  , intersector.ignoredEntity, intersector.damageableOnly
+  );
 
-    float intersectionLength;
-    bool const intersection =
-      ::IntersectionRayAabb(
-        rayOriginBegin, rayOriginEnd
-      , origin.origin + glm::vec2(hitbox.offset)
-      , glm::vec2(hitbox.dimensions)
-      , intersectionLength
-      );
+  // only the nearest hits.size() need to be ordered
+  auto & entityHits = ::LocalQueryScratch().rayEntityHits;
+  size_t const hitCount = glm::min(hits.size(), entityHits.size());
+  std::partial_sort(
+    entityHits.begin(), entityHits.begin() + hitCount, entityHits.end()
+  );
 
-    if (intersection) {
-      glm::vec2 const intersectionOrigin =
-          rayOriginBegin
-        + intersectionLength * glm::normalize(rayOriginEnd - rayOriginBegin)
-      ;
+  // as distance is relative to the full ray
+  float const timeScale =
+    intersector.ray.endOrigin == intersector.ray.beginOrigin
+  ? 0.0f
+  : glm::length(rayDelta)
+  / glm::length(
+      glm::vec2(intersector.ray.endOrigin - intersector.ray.beginOrigin)
+    );
 
-      intersectionResults.collision = true;
-      std::pair<glm::i32vec2, entt::entity> results;
-      std::get<0>(results) = glm::i32vec2(glm::round(intersectionOrigin));
-      std::get<1>(results) = entity;
-      intersectionResults.entities.emplace_back(results);
-    }
+  for (size_t it = 0ul; it < hitCount; ++ it) {
+    auto const & [timeOfImpact, entity] = entityHits[it];
+    hits[it].timeOfImpact = timeOfImpact * timeScale;
+    hits[it].origin =
+      glm::i32vec2(glm::round(rayOriginBegin + rayDelta*timeOfImpact));
+    hits[it].entity = entity;
   }
+
+  return hitCount;
 }
 
 void plugin::physics::EntityIntersectionCircle(
@@ -258,37 +1966,11 @@ void plugin::physics::EntityIntersectionCircle(
 , pul::physics::IntersectorCircle const & circle
 , pul::physics::EntityIntersectionResults & intersectionResults
 ) {
-  auto & registry = scene.EnttRegistry();
-
-  auto view =
-    registry.view<
-      pul::util::ComponentHitboxAABB
-    , pul::util::ComponentOrigin
-    >();
-
-  intersectionResults.entities.clear();
-
-  for (auto & entity : view) {
-    auto const & hitbox = view.get<pul::util::ComponentHitboxAABB>(entity);
-    auto const & origin = view.get<pul::util::ComponentOrigin>(entity);
-
-    glm::vec2 closestOrigin;
-    bool intersection =
-      ::IntersectionCircleAabb(
-        glm::vec2(circle.origin), circle.radius
-      , origin.origin + glm::vec2(hitbox.offset)
-      , glm::vec2(hitbox.dimensions)
-      , closestOrigin
-      );
+  ::GatherCircleEntityHits(scene.EnttRegistry(), circle);
 
-    if (intersection) {
-      intersectionResults.collision = true;
-      std::pair<glm::i32vec2, entt::entity> results;
-      std::get<0>(results) = glm::i32vec2(glm::round(closestOrigin));
-      std::get<1>(results) = entity;
-      intersectionResults.entities.emplace_back(results);
-    }
-  }
+  auto const & hits = ::LocalQueryScratch().circleEntityHits;
+  intersectionResults.collision = !hits.empty();
+  intersectionResults.entities.assign(hits.begin(), hits.end());
 }
 
 void plugin::physics::ProcessTileset(
@@ -298,12 +1980,14 @@ void plugin::physics::ProcessTileset(
   tileset = {};
   tileset.tiles.reserve((image.width / 32ul) * (image.height / 32ul));
 
+  auto constexpr gridSize = pul::physics::Tile::gridSize;
+
   // iterate thru every tile
   for (size_t tileY = 0ul; tileY < image.height / 32ul; ++ tileY)
   for (size_t tileX = 0ul; tileX < image.width  / 32ul; ++ tileX) {
     pul::physics::Tile tile;
 
-    auto constexpr gridSize = pul::physics::Tile::gridSize;
+    std::array<std::array<bool, gridSize>, gridSize> solid;
 
     // iterate thru every texel of the tile, stratified by physics tile GridSize
     for (size_t texelY = 0ul; texelY < 32ul; texelY += 32ul/gridSize)
@@ -316,19 +2000,179 @@ void plugin::physics::ProcessTileset(
       , gridTexelY = static_cast<size_t>(texelY*(gridSize/32.0f))
       ;
 
-      float const alpha =
+      auto const alpha =
         image.data[(image.height-imageTexelY-1)*image.width + imageTexelX].a;
 
-      tile.signedDistanceField[gridTexelX][gridTexelY] = alpha;
+      solid[gridTexelX][gridTexelY] = alpha > 0u;
+    }
+
+    // two-pass chessboard distance transform, computes for every texel the
+    // distance to the nearest texel whose solidity is `target`
+    auto const distanceTransform = [&solid](bool const target) {
+      int32_t constexpr maxDistance = static_cast<int32_t>(gridSize);
+      int32_t constexpr dim = static_cast<int32_t>(gridSize);
+
+      std::array<std::array<int32_t, gridSize>, gridSize> distance;
+
+      auto const fetch = [&distance](int32_t x, int32_t y) {
+        if (x < 0 || y < 0 || x >= dim || y >= dim) { return maxDistance; }
+        return distance[x][y];
+      };
+
+      for (int32_t y = 0; y < dim; ++ y)
+      for (int32_t x = 0; x < dim; ++ x) {
+        if (solid[x][y] == target) { distance[x][y] = 0; continue; }
+        distance[x][y] =
+          glm::min(
+            maxDistance
+          , 1 + glm::min(
+              glm::min(fetch(x-1, y), fetch(x-1, y-1))
+            , glm::min(fetch(x, y-1), fetch(x+1, y-1))
+            )
+          );
+      }
+
+      for (int32_t y = dim-1; y >= 0; -- y)
+      for (int32_t x = dim-1; x >= 0; -- x) {
+        distance[x][y] =
+          glm::min(
+            distance[x][y]
+          , 1 + glm::min(
+              glm::min(fetch(x+1, y), fetch(x+1, y+1))
+            , glm::min(fetch(x, y+1), fetch(x-1, y+1))
+            )
+          );
+      }
+
+      return distance;
+    };
+
+    auto const distanceToSolid = distanceTransform(true);
+    auto const distanceToEmpty = distanceTransform(false);
+
+    tile.rowMasks = {};
+    tile.columnMasks = {};
+
+    size_t solidCount = 0ul;
+
+    for (size_t x = 0ul; x < gridSize; ++ x)
+    for (size_t y = 0ul; y < gridSize; ++ y) {
+      tile.signedDistanceField[x][y] =
+        static_cast<int8_t>(
+          solid[x][y] ? -distanceToEmpty[x][y] : +distanceToSolid[x][y]
+        );
+
+      if (solid[x][y]) {
+        tile.rowMasks[y]    |= 1u << x;
+        tile.columnMasks[x] |= 1u << y;
+        ++ solidCount;
+      }
+    }
+
+    // -- surface normals, texels outside of the tile are clamped to its
+    //    border, which extends the surface along the same direction
+    for (int32_t x = 0; x < static_cast<int32_t>(gridSize); ++ x)
+    for (int32_t y = 0; y < static_cast<int32_t>(gridSize); ++ y) {
+      tile.surfaceNormals[x][y] =
+        ::QuantizeNormal(
+          ::NeighbourhoodNormal([&](int32_t const ox, int32_t const oy) {
+            int32_t constexpr last = static_cast<int32_t>(gridSize) - 1;
+            return
+              solid[glm::clamp(x+ox, 0, last)][glm::clamp(y+oy, 0, last)];
+          })
+        );
+    }
+
+    // -- classify tile for acceleration hints
+    using Hint = pul::physics::TileIntersectAccelerationHint;
+    tile.accelerationHint = Hint::Default;
+    if (solidCount == 0ul) {
+      tile.accelerationHint = Hint::Empty;
+    } else if (solidCount == gridSize*gridSize) {
+      tile.accelerationHint = Hint::Full;
     }
 
     tileset.tiles.emplace_back(tile);
   }
 }
 
+void plugin::physics::LoadTileset(
+  pul::physics::Tileset & tileset
+, pul::gfx::Image const & image
+, char const * cacheDirectory
+) {
+  ::TilesetCacheHeader expectedHeader;
+  expectedHeader.tileCount = (image.width / 32ul) * (image.height / 32ul);
+
+  // without the file bytes there's nothing to key the cache on
+  if (!::FileHash(image.filename, expectedHeader.fileHash)) {
+    spdlog::debug(
+      "not caching physics tileset of unreadable '{}'", image.filename
+    );
+    plugin::physics::ProcessTileset(tileset, image);
+    return;
+  }
+
+  std::string const cachePath =
+    (
+      std::filesystem::path(cacheDirectory)
+    / fmt::format("{:016x}.physics", expectedHeader.fileHash)
+    ).string();
+
+  { // -- try loading from cache
+    auto file = std::ifstream{cachePath, std::ios::binary};
+    ::TilesetCacheHeader header;
+    if (
+        file.good()
+     && file.read(reinterpret_cast<char *>(&header), sizeof(header))
+     && header == expectedHeader
+    ) {
+      tileset = {};
+      tileset.tiles.resize(header.tileCount);
+      for (auto & tile : tileset.tiles) {
+        ::ForEachCachedTileField(tile, [&file](auto & field) {
+          file.read(reinterpret_cast<char *>(&field), sizeof(field));
+        });
+      }
+
+      if (file.good()) {
+        spdlog::debug("loaded cached physics tileset '{}'", cachePath);
+        return;
+      }
+    }
+  }
+
+  plugin::physics::ProcessTileset(tileset, image);
+
+  { // -- write cache, failing to do so only costs the next load
+    std::error_code error;
+    std::filesystem::create_directories(cacheDirectory, error);
+
+    auto file = std::ofstream{cachePath, std::ios::binary | std::ios::trunc};
+    file.write(
+      reinterpret_cast<char const *>(&expectedHeader), sizeof(expectedHeader)
+    );
+    for (auto & tile : tileset.tiles) {
+      ::ForEachCachedTileField(tile, [&file](auto const & field) {
+        file.write(reinterpret_cast<char const *>(&field), sizeof(field));
+      });
+    }
+
+    if (error || !file.good()) {
+      spdlog::error("could not write physics tileset cache '{}'", cachePath);
+    }
+  }
+}
+
+void plugin::physics::Shutdown() {
+  ::queryScratches = {};
+  ::entityBroadphase = {};
+}
+
 void plugin::physics::ClearMapGeometry() {
   boxWorld = nullptr;
-  tilemapLayer = {};
+  ::chunkStaticBodies.clear();
+  ::physicsWorld = {};
 }
 
 void plugin::physics::LoadMapGeometry(
@@ -355,23 +2199,20 @@ void plugin::physics::LoadMapGeometry(
     return;
   }
 
-  // -- compute max width/height of tilemap
-  uint32_t width = 0ul, height = 0ul;
-  for (auto & tileOrigins : mapTileOrigins)
-  for (auto & origin : tileOrigins) {
-    width = std::max(width, origin.x+1);
-    height = std::max(height, origin.y+1);
+  if (tilesets.size() >= pul::physics::TilemapLayer::TileInfo::maxTilesets) {
+    spdlog::critical("too many tilesets on the collision layer");
+    return;
   }
-  ::tilemapLayer.width = width;
 
-  // copy tilesets over
-  ::tilemapLayer.tilesets =
-    decltype(::tilemapLayer.tilesets){tilesets.begin(), tilesets.end()};
+  using Layer = pul::physics::TilemapLayer;
+  auto & layer = ::physicsWorld.tilemapLayer;
 
-  // resize
-  ::tilemapLayer.tileInfo.resize(width * height);
+  // copy tilesets over
+  layer.tilesets =
+    decltype(layer.tilesets){tilesets.begin(), tilesets.end()};
 
-  // cache tileset info for quick tile fetching
+  // cache tileset info for quick tile fetching, chunks are allocated as tiles
+  // land in them
   for (size_t tilesetIdx = 0ul; tilesetIdx < tilesets.size(); ++ tilesetIdx) {
     auto const & tileIndices = mapTileIndices[tilesetIdx];
     auto const & tileOrigins = mapTileOrigins[tilesetIdx];
@@ -388,35 +2229,75 @@ void plugin::physics::LoadMapGeometry(
         imageTileIdx, <, tilesets[tilesetIdx]->tiles.size(), continue;
       );
 
-      size_t const tileIdx = tileOrigin.y * width + tileOrigin.x;
+      PUL_ASSERT_CMP(
+        imageTileIdx, <, pul::physics::TilemapLayer::TileInfo::maxImageTiles
+      , continue;
+      );
+
+      glm::i32vec2 const
+        chunkOrigin = ::FloorDiv(glm::i32vec2(tileOrigin), Layer::chunkTiles)
+      , chunkTile = glm::i32vec2(tileOrigin) - chunkOrigin*Layer::chunkTiles
+      ;
 
-      PUL_ASSERT_CMP(tileIdx, <, ::tilemapLayer.tileInfo.size(), continue;);
+      auto & chunk = layer.chunks[Layer::GridKey(chunkOrigin)];
+      chunk.origin = chunkOrigin;
 
-      auto & tile = ::tilemapLayer.tileInfo[tileIdx];
-      if (tile.imageTileIdx != -1ul) {
+      auto & tile =
+        chunk.tileInfo[chunkTile.y*Layer::chunkTiles + chunkTile.x];
+      if (tile.Valid()) {
         spdlog::error("multiple tiles are intersecting on the collision layer");
         continue;
       }
 
-      tile.tilesetIdx   = tilesetIdx;
-      tile.imageTileIdx = imageTileIdx;
-      tile.origin       = tileOrigin;
-      tile.orientation  = tileOrientation;
-
-      if (tile.imageTileIdx > 0) {
-        b2BodyDef tileBodyDef;
-        tileBodyDef.position.Set(
-          tileOrigin.x*32.0f*Consts::pixelsToMeters,
-          tileOrigin.y*32.0f*Consts::pixelsToMeters
+      tile =
+        pul::physics::TilemapLayer::TileInfo::Construct(
+          tilesetIdx, imageTileIdx, tileOrientation
         );
-
-        b2Body * tileBody = boxWorld->CreateBody(&tileBodyDef);
-        b2PolygonShape tileBox;
-        tileBox.SetAsBox(16.0f, 16.0f);
-        tileBody->CreateFixture(&tileBox, 0.0f);
-      }
     }
   }
+
+  for (auto & [key, chunk] : layer.chunks)
+    { ::FinalizeChunk(layer, chunk); }
+
+  for (auto & [key, chunk] : layer.chunks)
+    { ::BuildSeamNormals(layer, chunk); }
+}
+
+void plugin::physics::LoadMapChunk(
+  glm::i32vec2 const chunkOrigin
+, std::span<pul::physics::TilemapLayer::TileInfo const> const tileInfo
+) {
+  using Layer = pul::physics::TilemapLayer;
+  auto & layer = ::physicsWorld.tilemapLayer;
+
+  PUL_ASSERT_CMP(
+    tileInfo.size(), ==
+  , static_cast<size_t>(Layer::chunkTiles*Layer::chunkTiles)
+  , return;
+  );
+
+  for (auto const & tile : tileInfo) {
+    if (!tile.Valid()) { continue; }
+    PUL_ASSERT_CMP(tile.TilesetIdx(), <, layer.tilesets.size(), return;);
+    PUL_ASSERT_CMP(
+      tile.ImageTileIdx(), <, layer.tilesets[tile.TilesetIdx()]->tiles.size()
+    , return;
+    );
+  }
+
+  ::EraseChunk(chunkOrigin);
+
+  auto & chunk = layer.chunks[Layer::GridKey(chunkOrigin)];
+  chunk.origin = chunkOrigin;
+  std::copy(tileInfo.begin(), tileInfo.end(), chunk.tileInfo.begin());
+
+  ::FinalizeChunk(layer, chunk);
+  ::BuildNeighbourhoodSeamNormals(layer, chunkOrigin);
+}
+
+void plugin::physics::UnloadMapChunk(glm::i32vec2 const chunkOrigin) {
+  ::EraseChunk(chunkOrigin);
+  ::BuildNeighbourhoodSeamNormals(::physicsWorld.tilemapLayer, chunkOrigin);
 }
 
 b2Body * plugin::physics::CreateDynamicBody(
@@ -455,119 +2336,383 @@ void plugin::physics::SimulatePhysics() {
 }
 
 bool plugin::physics::InverseSceneIntersectionRaycast(
-  pul::core::SceneBundle &
+  pul::physics::PhysicsWorld const & world
 , pul::physics::IntersectorRay const & ray
 , pul::physics::IntersectionResults & intersectionResults
 ) {
   intersectionResults = {};
-  // TODO this is slow and can be optimized by using SDFs
-  pul::physics::BresenhamLine(
-    ray.beginOrigin, ray.endOrigin
-  , [&](int32_t x, int32_t y) {
-      if (intersectionResults.collision) { return; }
-      auto origin = glm::i32vec2(x, y);
-      // -- get physics tile from acceleration structure
-
-      // calculate tile indices, not for the spritesheet but for the tile in
-      // the physx map
-      size_t tileIdx;
-      glm::u32vec2 texelOrigin;
+
+  ::ResolvedTile tile;
+  ::TraceRay(world.tilemapLayer, ray, true, intersectionResults, tile);
+  ::RenderRayQuery(ray, intersectionResults);
+
+  return intersectionResults.collision;
+}
+
+bool plugin::physics::IntersectionRaycast(
+  pul::physics::PhysicsWorld const & world
+, pul::physics::IntersectorRay const & ray
+, pul::physics::IntersectionResults & intersectionResults
+) {
+  intersectionResults = {};
+
+  ::ResolvedTile tile;
+  ::TraceRay(world.tilemapLayer, ray, false, intersectionResults, tile);
+  ::RenderRayQuery(ray, intersectionResults);
+
+  return intersectionResults.collision;
+}
+
+bool plugin::physics::IntersectionRaycastBatch(
+  pul::physics::PhysicsWorld const & world
+, std::span<pul::physics::IntersectorRay const> const rays
+, std::span<pul::physics::IntersectionResults> const intersectionResults
+) {
+  PUL_ASSERT_CMP(rays.size(), ==, intersectionResults.size(), return false;);
+
+  // trace the rays ordered by the tile they begin in, so rays beginning in
+  // the same tile run back-to-back; every tile & chunk resolved by a ray is
+  // shared with the rest of the batch through the tile cache
+  auto & batchRayOrder = ::LocalQueryScratch().batchRayOrder;
+  batchRayOrder.clear();
+  for (size_t rayIdx = 0ul; rayIdx < rays.size(); ++ rayIdx) {
+    batchRayOrder.emplace_back(
+      pul::physics::TilemapLayer::GridKey(
+        ::FloorDiv(rays[rayIdx].beginOrigin, 32)
+      )
+    , rayIdx
+    );
+  }
+
+  std::sort(batchRayOrder.begin(), batchRayOrder.end());
+
+  bool collision = false;
+  ::ResolvedTileCache tileCache;
+  for (auto const & [tileKey, rayIdx] : batchRayOrder) {
+    auto & results = intersectionResults[rayIdx];
+    results = {};
+
+    ::ResolvedTile tile;
+    ::TraceRay(
+      world.tilemapLayer, rays[rayIdx], false, results, tile, &tileCache
+    );
+    ::RenderRayQuery(rays[rayIdx], results);
+
+    collision = collision || results.collision;
+  }
+
+  return collision;
+}
+
+bool plugin::physics::IntersectionSweptAabb(
+  pul::physics::PhysicsWorld const & world
+, pul::physics::IntersectorSweptAabb const & sweep
+, pul::physics::SweptIntersectionResults & intersectionResults
+) {
+  intersectionResults = {};
+
+  if (sweep.velocity == glm::vec2(0.0f)) { return false; }
+
+  int32_t constexpr tileSize =
+    static_cast<int32_t>(pul::physics::Tile::gridSize);
+
+  glm::vec2 const
+    boxMin = ::GetAabbMin(sweep.origin, sweep.dimensions)
+  , boxMax = ::GetAabbMax(sweep.origin, sweep.dimensions)
+  ;
+
+  // bounds of every texel the box can touch during the sweep
+  auto const sweepMin =
+    glm::i32vec2(glm::floor(glm::min(boxMin, boxMin + sweep.velocity)));
+  auto const sweepMax =
+    glm::i32vec2(glm::ceil(glm::max(boxMax, boxMax + sweep.velocity)))
+  - glm::i32vec2(1);
+
+  // walk the rows of the bounds one tile at a time, only solid texels from the
+  // row masks are tested against the box
+  ::ResolvedTile tile;
+  for (int32_t y = sweepMin.y; y <= sweepMax.y; ++ y)
+  for (int32_t x = sweepMin.x; x <= sweepMax.x;) {
+    int32_t const tileBegin = ::FloorDiv(x, tileSize)*tileSize;
+    int32_t const tileEnd = tileBegin + tileSize;
+
+    glm::u32vec2 texelOrigin;
+    if (
+      !::ResolveTile(world.tilemapLayer, tile, texelOrigin, glm::i32vec2(x, y))
+    ) {
+      x = tileEnd;
+      continue;
+    }
+
+    uint32_t const
+      spanBegin = texelOrigin.x
+    , spanEnd =
+        static_cast<uint32_t>(glm::min(sweepMax.x, tileEnd-1) - tileBegin)
+    ;
+
+    uint32_t mask =
+        ::SpanMask(tile, texelOrigin, true)
+      & (~0u << spanBegin) & (~0u >> (31u - spanEnd))
+    ;
+
+    for (; mask != 0u; mask &= mask - 1u) {
+      auto const texel =
+        glm::i32vec2(tileBegin + std::countr_zero(mask), y);
+
+      float timeOfImpact;
+      size_t axis;
       if (
-        !pul::util::CalculateTileIndices(
-          tileIdx, texelOrigin, origin
-        , ::tilemapLayer.width, ::tilemapLayer.tileInfo.size()
+        !::IntersectionSweptAabbTexel(
+          boxMin, boxMax, sweep.velocity, glm::vec2(texel)
+        , timeOfImpact, axis
         )
       ) {
-        return;
+        continue;
       }
 
-      PUL_ASSERT_CMP(::tilemapLayer.tileInfo.size(), >, tileIdx, return;);
-      auto const & tileInfo = ::tilemapLayer.tileInfo[tileIdx];
-
-      if (::CalculateSdfDistance(tileInfo, texelOrigin) == 0.0f) {
-        intersectionResults =
-          pul::physics::IntersectionResults {
-            true, origin, tileInfo.imageTileIdx, tileInfo.tilesetIdx
-          };
+      if (
+          intersectionResults.collision
+       && timeOfImpact >= intersectionResults.timeOfImpact
+      ) {
+        continue;
       }
+
+      intersectionResults.collision = true;
+      intersectionResults.timeOfImpact = timeOfImpact;
+      intersectionResults.normal = glm::vec2(0.0f);
+      intersectionResults.normal[axis] = -glm::sign(sweep.velocity[axis]);
+      intersectionResults.origin = texel;
+      intersectionResults.imageTileIdx = tile.tileInfo->ImageTileIdx();
+      intersectionResults.tilesetIdx = tile.tileInfo->TilesetIdx();
     }
-  );
+
+    x = tileEnd;
+  }
 
   if (::showPhysicsQueries) {
-    plugin::debug::RenderLine(
-      ray.beginOrigin, ray.endOrigin,
-      intersectionResults.collision
-    ? glm::vec4(1.0f, 0.2f, 0.2f, 1.0f) : glm::vec4(0.2f, 1.0f, 0.2f, 1.0f)
+    plugin::debug::RenderAabbByCenter(
+      sweep.origin + sweep.velocity*intersectionResults.timeOfImpact
+    , sweep.dimensions
+    , intersectionResults.collision
+    ? glm::vec3(1.0f, 0.2f, 0.2f) : glm::vec3(0.2f, 1.0f, 0.2f)
     );
   }
 
   return intersectionResults.collision;
 }
 
-bool plugin::physics::IntersectionRaycast(
-  pul::core::SceneBundle &
-, pul::physics::IntersectorRay const & ray
-, pul::physics::IntersectionResults & intersectionResults
+bool plugin::physics::IntersectionSweptCircle(
+  pul::physics::PhysicsWorld const & world
+, pul::core::SceneBundle & scene
+, pul::physics::IntersectorSweptCircle const & sweep
+, pul::physics::SweptCircleIntersectionResults & intersectionResults
 ) {
   intersectionResults = {};
-  // TODO this is slow and can be optimized by using SDFs
-  pul::physics::BresenhamLine(
-    ray.beginOrigin, ray.endOrigin
-  , [&](int32_t x, int32_t y) {
-      if (intersectionResults.collision) { return; }
-      auto origin = glm::i32vec2(x, y);
-      // -- get physics tile from acceleration structure
-
-      // calculate tile indices, not for the spritesheet but for the tile in
-      // the physx map
-      size_t tileIdx;
-      glm::u32vec2 texelOrigin;
+
+  if (sweep.testLayer && sweep.radius <= 0.0f) { // -- collision layer
+    auto const ray =
+      pul::physics::IntersectorRay::Construct(
+        sweep.origin, sweep.origin + sweep.velocity
+      );
+
+    pul::physics::IntersectionResults results;
+    ::ResolvedTile tile;
+    ::TraceRay(world.tilemapLayer, ray, false, results, tile);
+    ::RenderRayQuery(ray, results);
+
+    if (results.collision) {
+      float const rayLength =
+        glm::length(glm::vec2(ray.endOrigin - ray.beginOrigin));
+
+      intersectionResults.collision = true;
+      intersectionResults.timeOfImpact =
+        rayLength == 0.0f
+      ? 0.0f
+      : glm::min(
+          1.0f
+        , glm::length(glm::vec2(results.origin - ray.beginOrigin))
+        / rayLength
+        );
+      intersectionResults.normal = results.normal;
+      intersectionResults.imageTileIdx = results.imageTileIdx;
+      intersectionResults.tilesetIdx = results.tilesetIdx;
+    }
+  } else if (sweep.testLayer) {
+    // the circle is swept as its bounding box against the texels
+    pul::physics::IntersectorSweptAabb aabb;
+    aabb.origin = sweep.origin;
+    aabb.dimensions = glm::vec2(sweep.radius*2.0f);
+    aabb.velocity = sweep.velocity;
+
+    pul::physics::SweptIntersectionResults results;
+    if (plugin::physics::IntersectionSweptAabb(world, aabb, results)) {
+      intersectionResults.collision = true;
+      intersectionResults.timeOfImpact = results.timeOfImpact;
+      intersectionResults.normal = results.normal;
+      intersectionResults.imageTileIdx = results.imageTileIdx;
+      intersectionResults.tilesetIdx = results.tilesetIdx;
+    }
+  }
+
+  if (sweep.testEntities) { // -- entity hitboxes, only up to the tile contact
+    auto & registry = scene.EnttRegistry();
+
+    auto view =
+      registry.view<
+        pul::util::ComponentHitboxAABB
+      , pul::util::ComponentOrigin
+      >();
+
+    glm::vec2 const reach = sweep.velocity*intersectionResults.timeOfImpact;
+
+    auto const testEntity = [&](entt::entity const entity) {
+      // entity could have been destroyed since the broadphase was built
+      if (
+          entity == sweep.ignoredEntity
+       || std::find(
+            sweep.ignoredEntities.begin(), sweep.ignoredEntities.end(), entity
+          ) != sweep.ignoredEntities.end()
+       || !registry.valid(entity)
+       || !registry.has<
+            pul::util::ComponentHitboxAABB, pul::util::ComponentOrigin
+          >(entity)
+      ) {
+        return;
+      }
+
+      auto const & hitbox = view.get<pul::util::ComponentHitboxAABB>(entity);
+      auto const & origin = view.get<pul::util::ComponentOrigin>(entity);
+
+      // hitbox grown by the radius, so the circle sweeps as a point
+      auto const center = origin.origin + glm::vec2(hitbox.offset);
+      auto const dimensions = glm::vec2(hitbox.dimensions);
+
+      float timeOfImpact;
+      glm::vec2 normal;
       if (
-        !pul::util::CalculateTileIndices(
-          tileIdx, texelOrigin, origin
-        , ::tilemapLayer.width, ::tilemapLayer.tileInfo.size()
+        !::IntersectionSegmentAabb(
+          sweep.origin, sweep.velocity
+        , ::GetAabbMin(center, dimensions) - sweep.radius
+        , ::GetAabbMax(center, dimensions) + sweep.radius
+        , timeOfImpact, normal
         )
       ) {
         return;
       }
 
-      PUL_ASSERT_CMP(::tilemapLayer.tileInfo.size(), >, tileIdx, return;);
-      auto const & tileInfo = ::tilemapLayer.tileInfo[tileIdx];
+      if (
+          intersectionResults.collision
+       && timeOfImpact >= intersectionResults.timeOfImpact
+      ) {
+        return;
+      }
 
-      if (::CalculateSdfDistance(tileInfo, texelOrigin) > 0.0f) {
-        intersectionResults =
-          pul::physics::IntersectionResults {
-            true, origin, tileInfo.imageTileIdx, tileInfo.tilesetIdx
-          };
+      intersectionResults.collision = true;
+      intersectionResults.timeOfImpact = timeOfImpact;
+      intersectionResults.normal = normal;
+      intersectionResults.entity = entity;
+      intersectionResults.imageTileIdx = -1ul;
+      intersectionResults.tilesetIdx = -1ul;
+    };
+
+    if (!::useEntityBroadphase) {
+      for (auto entity : view) { testEntity(entity); }
+    } else {
+      // the cells along the sweep up to the tile contact
+      ::LocalQueryScratch().broadphaseCandidates.clear();
+      if (sweep.radius <= 0.0f) {
+        ::GatherSegmentBuckets(sweep.origin, reach);
+      } else {
+        // a cell length at a time, bounds of each piece grown by the radius
+        float constexpr cellSize =
+          static_cast<float>(EntityBroadphase::cellSize);
+
+        int32_t const pieces =
+          glm::max(
+            1, static_cast<int32_t>(glm::ceil(glm::length(reach)/cellSize))
+          );
+
+        for (int32_t piece = 0; piece < pieces; ++ piece) {
+          glm::vec2 const
+            begin = sweep.origin + reach*(piece / static_cast<float>(pieces))
+          , end = sweep.origin + reach*((piece+1) / static_cast<float>(pieces))
+          ;
+
+          auto const cellMin =
+            glm::i32vec2(
+              glm::floor((glm::min(begin, end) - sweep.radius)/cellSize)
+            );
+          auto const cellMax =
+            glm::i32vec2(
+              glm::floor((glm::max(begin, end) + sweep.radius)/cellSize)
+            );
+
+          for (int32_t y = cellMin.y; y <= cellMax.y; ++ y)
+          for (int32_t x = cellMin.x; x <= cellMax.x; ++ x)
+            { ::GatherBucketEntities(::BroadphaseBucket(glm::i32vec2(x, y))); }
+        }
       }
+      ::ForEachCandidateEntity(testEntity);
     }
-  );
+  }
 
-  if (::showPhysicsQueries) {
-    plugin::debug::RenderLine(
-      ray.beginOrigin, ray.endOrigin,
+  intersectionResults.origin =
+    sweep.origin + sweep.velocity*intersectionResults.timeOfImpact;
+
+  if (
       intersectionResults.collision
-    ? glm::vec4(1.0f, 0.2f, 0.2f, 1.0f) : glm::vec4(0.2f, 1.0f, 0.2f, 1.0f)
-    );
+   && intersectionResults.normal == glm::vec2(0.0f)
+   && sweep.velocity != glm::vec2(0.0f)
+  ) {
+    intersectionResults.normal = -glm::normalize(sweep.velocity);
   }
 
   return intersectionResults.collision;
 }
 
-pul::physics::TilemapLayer * plugin::physics::TilemapLayer() {
-  return &tilemapLayer;
+pul::physics::PhysicsWorld const & plugin::physics::World() {
+  return ::physicsWorld;
 }
 
 bool plugin::physics::IntersectionAabb(
-  pul::core::SceneBundle &
-, pul::physics::IntersectorAabb const &
-, pul::physics::IntersectionResults &
+  pul::physics::PhysicsWorld const & world
+, pul::physics::IntersectorAabb const & aabb
+, pul::physics::IntersectionResults & intersectionResults
 ) {
-  return false;
+  intersectionResults = {};
+
+  // texels the aabb covers
+  auto const texelMin =
+    glm::i32vec2(glm::floor(::GetAabbMin(aabb.origin, aabb.dimensions)));
+  auto const texelMax =
+    glm::i32vec2(glm::ceil(::GetAabbMax(aabb.origin, aabb.dimensions)))
+  - glm::i32vec2(1);
+
+  // a single pass over the range, which also reports a solid texel to
+  // resolve the tile & normal from
+  auto const & layer = world.tilemapLayer;
+  glm::i32vec2 solidTexel;
+  if (::SolidTexelCount(layer, texelMin, texelMax, &solidTexel) > 0u) {
+    ::ResolvedTile tile;
+    glm::u32vec2 texelOrigin;
+    if (::ResolveTile(layer, tile, texelOrigin, solidTexel)) {
+      intersectionResults = ::TileResults(tile, solidTexel);
+    }
+  }
+
+  if (::showPhysicsQueries) {
+    plugin::debug::RenderAabbByCenter(
+      aabb.origin, aabb.dimensions
+    , intersectionResults.collision
+    ? glm::vec3(1.0f, 0.2f, 0.2f) : glm::vec3(0.2f, 1.0f, 0.2f)
+    );
+  }
+
+  return intersectionResults.collision;
 }
 
 bool plugin::physics::IntersectionPoint(
-  pul::core::SceneBundle &
+  pul::physics::PhysicsWorld const & world
 , pul::physics::IntersectorPoint const & point
 , pul::physics::IntersectionResults & intersectionResults
 ) {
@@ -575,26 +2720,15 @@ bool plugin::physics::IntersectionPoint(
 
 
   // -- get physics tile from acceleration structure
-  size_t tileIdx;
+  ::ResolvedTile tile;
   glm::u32vec2 texelOrigin;
-  if (
-    !pul::util::CalculateTileIndices(
-      tileIdx, texelOrigin, point.origin
-    , ::tilemapLayer.width, ::tilemapLayer.tileInfo.size()
-    )
-  ) {
+  if (!::ResolveTile(world.tilemapLayer, tile, texelOrigin, point.origin)) {
     // TODO point
     return false;
   }
 
-  PUL_ASSERT_CMP(::tilemapLayer.tileInfo.size(), >, tileIdx, return false;);
-  auto const & tileInfo = ::tilemapLayer.tileInfo[tileIdx];
-
-  if (::CalculateSdfDistance(tileInfo, texelOrigin) > 0.0f) {
-    intersectionResults =
-      pul::physics::IntersectionResults {
-        true, point.origin, tileInfo.imageTileIdx, tileInfo.tilesetIdx
-      };
+  if (::TexelSolid(tile, texelOrigin)) {
+    intersectionResults = ::TileResults(tile, point.origin);
 
     // TODO point
     return true;
@@ -607,10 +2741,22 @@ bool plugin::physics::IntersectionPoint(
 void plugin::physics::DebugUiDispatch(pul::core::SceneBundle &) {
   ImGui::Begin("Physics");
 
-  pul::imgui::Text("tilemap width {}", ::tilemapLayer.width);
-  pul::imgui::Text("tile info size {}", ::tilemapLayer.tileInfo.size());
+  auto const & layer = ::physicsWorld.tilemapLayer;
+  pul::imgui::Text("loaded chunks {}", layer.chunks.size());
+  pul::imgui::Text("static bodies {}", ::chunkStaticBodies.size());
 
   ImGui::Checkbox("show physics queries", &::showPhysicsQueries);
+  ImGui::Checkbox("accelerated raycasts", &::useAcceleratedRaycasts);
+  ImGui::Checkbox("entity broadphase", &::useEntityBroadphase);
+  pul::imgui::Text(
+    "broadphase entities {}", ::entityBroadphase.entries.size()
+  );
+  pul::imgui::Text(
+    "broadphase margin overruns {}", ::entityBroadphase.marginOverruns
+  );
+  pul::imgui::Text(
+    "query scratch {} KiB", ::QueryScratchCapacityBytes() / 1024ul
+  );
 
   ImGui::End();
 }